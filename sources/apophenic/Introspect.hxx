@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <type_traits>
+#include <typeinfo>
+#include <utility>
 
 
 namespace ap
@@ -61,6 +64,8 @@ template< typename MemberType, class Base, MemberType Base::*ptr_to_member >
 struct Member< ptr_to_member >
 {
 	using type = MemberType;
+	using base_type = Base;
+	static constexpr MemberType Base::* kPOINTER = ptr_to_member;
 	static char const * const kNAME;
 
 	template< class T, class Implementor >
@@ -72,6 +77,14 @@ struct Member< ptr_to_member >
 
 
 
+template< typename... Members >
+struct MemberList
+{
+	static constexpr ::std::size_t kSIZE = sizeof...( Members );
+};
+
+
+
 template< unsigned RANK, class Implementor, typename Member, typename... NextMembers >
 class RankedIntrospector : public RankedIntrospector< RANK+1, Implementor, NextMembers... >
 {
@@ -79,6 +92,7 @@ public:
 	using MemberType = typename Member::type;
 	using Parent = RankedIntrospector< RANK+1, Implementor, NextMembers... >;
 	using Introspector = RankedIntrospector< RANK, Implementor, Member, NextMembers... >;
+	using Members = MemberList< Member, NextMembers... >;
 
 
 	Introspector & introspector() { return *this; }
@@ -236,6 +250,7 @@ class RankedIntrospector< RANK, Implementor, Member >
 public:
 	using MemberType = typename Member::type;
 	using Introspector = RankedIntrospector< RANK, Implementor, Member >;
+	using Members = MemberList< Member >;
 
 
 	Introspector & introspector() { return *this; }
@@ -379,5 +394,122 @@ using Introspector = RankedIntrospector< 0, Implementor, Members... >;
 
 
 
+template< typename T, typename = void >
+struct is_introspected : ::std::false_type {};
+
+template< typename T >
+struct is_introspected< T, ::std::void_t< typename T::Members > > : ::std::true_type {};
+
+
+
+template< unsigned RANK, typename Member >
+struct _RankedMember { using type = Member; };
+
+template< typename Ranks, typename... Members >
+struct _RankedMembers;
+
+template< unsigned... RANKS, typename... Members >
+struct _RankedMembers< ::std::integer_sequence< unsigned, RANKS... >, Members... > : _RankedMember< RANKS, Members >... {};
+
+template< unsigned RANK, typename Member >
+_RankedMember< RANK, Member > _member_at( _RankedMember< RANK, Member > const * );
+
+
+// Member of rank RANK, picked by overload resolution among ranked bases rather than by
+// recursion, so that wide member lists do not nest instantiations.
+template< unsigned RANK, typename Members >
+struct member_at;
+
+template< unsigned RANK, typename... Members >
+struct member_at< RANK, MemberList< Members... > >
+	: decltype( _member_at< RANK >( static_cast< _RankedMembers< ::std::make_integer_sequence< unsigned, sizeof...( Members ) >, Members... > const * >( nullptr ) ) ) {};
+
+
+
+template< typename Function, typename... Members, ::std::size_t... RANKS >
+void _for_each_member( MemberList< Members... >, ::std::index_sequence< RANKS... >, Function && function )
+{
+	( function( ::std::integral_constant< unsigned, RANKS >{}, Members{} ), ... );
+}
+
+
+// Calls function( integral_constant<unsigned, RANK>, Member ) for every member, in rank order.
+template< class Implementor, typename Function >
+void for_each_member( Function && function )
+{
+	using Members = typename Implementor::Members;
+	_for_each_member( Members{}, ::std::make_index_sequence< Members::kSIZE >{}, function );
+}
+
+
+// Offset of a member inside Implementor. Ptr-to-member constants make this fold at compile time
+// once inlined, even though it is not a constant expression.
+template< class Implementor, typename Member >
+::std::size_t member_offset()
+{
+	alignas( Implementor ) static unsigned char const storage[ sizeof( Implementor ) ] = {};
+	Implementor const * const object = reinterpret_cast< Implementor const * >( storage );
+	return reinterpret_cast< char const * >( &(object->*Member::kPOINTER) )
+		- reinterpret_cast< char const * >( object );
+}
+
+
+
+// Member access resolved once from a name or a rank: type checking and lookup happen
+// at construction, each access is then a fixed offset from the object.
+template< class Implementor, typename OtherType >
+class MemberHandle
+{
+public:
+	using type = OtherType;
+
+	explicit MemberHandle( ::std::string const & name ) : _rank( 0 ), _offset( 0 )
+	{
+		bool found = false;
+
+		for_each_member< Implementor >( [&]( auto rank, auto member )
+		{
+			if ( found || decltype( member )::kNAME != name ) return;
+			found = true;
+			_bind( rank, member );
+		} );
+
+		if ( false == found ) throw EBadName{};
+	}
+
+	explicit MemberHandle( unsigned rank ) : _rank( 0 ), _offset( 0 )
+	{
+		if ( rank >= Implementor::Members::kSIZE ) throw EBadRank{};
+
+		for_each_member< Implementor >( [&]( auto member_rank, auto member )
+		{
+			if ( member_rank == rank ) _bind( member_rank, member );
+		} );
+	}
+
+	unsigned rank() const { return _rank; }
+	::std::size_t offset() const { return _offset; }
+
+	typename member_read<OtherType>::type get( Implementor const & object ) const
+		{ return *reinterpret_cast< OtherType const * >( reinterpret_cast< char const * >( &object ) + _offset ); }
+
+	typename member_access<OtherType>::type get( Implementor & object ) const
+		{ return *reinterpret_cast< OtherType * >( reinterpret_cast< char * >( &object ) + _offset ); }
+
+private:
+	template< typename Member >
+	void _bind( unsigned rank, Member )
+	{
+		if ( false == ::std::is_same< OtherType, typename Member::type >::value ) throw EBadType{};
+		_rank = rank;
+		_offset = member_offset< Implementor, Member >();
+	}
+
+	unsigned _rank;
+	::std::size_t _offset;
+};
+
+
+
 } // namespace insp
 } // namespace ap
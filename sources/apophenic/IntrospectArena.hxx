@@ -0,0 +1,284 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "apophenic/Introspect.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+// Arena form of a member type: the type stored in an ArenaRecord, drawing its memory from
+// the record allocator. Trivially destructible types are stored as is; other types need a
+// specialization, as done for strings.
+template< typename Target, typename Source >
+void _arena_assign( Target & target, Source const & source )
+{
+	if constexpr ( ::std::is_array< Target >::value )
+	{
+		for ( ::std::size_t i = 0; i < ::std::extent< Target >::value; ++i ) _arena_assign( target[i], source[i] );
+	}
+	else
+	{
+		target = source;
+	}
+}
+
+
+template< typename StorageType, typename = void >
+struct arena_traits
+{
+	static_assert( ::std::is_trivially_destructible< StorageType >::value, "Member type has no arena form" );
+
+	using type = typename ::std::remove_const< StorageType >::type;
+
+	static void store( type & target, StorageType const & source ) { _arena_assign( target, source ); }
+	static void load( type & target, type const & source ) { _arena_assign( target, source ); }
+};
+
+
+template< typename StorageType >
+struct arena_traits< StorageType, typename ::std::enable_if< ::std::is_same< typename ::std::remove_const< StorageType >::type, ::std::string >::value >::type >
+{
+	using type = ::std::pmr::string;
+
+	static void store( type & target, ::std::string const & source ) { target.assign( source.data(), source.size() ); }
+	static void load( ::std::string & target, type const & source ) { target.assign( source.data(), source.size() ); }
+};
+
+
+
+template< typename Member >
+using arena_type = typename arena_traits< typename Member::type >::type;
+
+
+template< unsigned RANK, typename Member, bool = ::std::uses_allocator< arena_type< Member >, ::std::pmr::polymorphic_allocator< ::std::byte > >::value >
+struct _ArenaField
+{
+	explicit _ArenaField( ::std::pmr::polymorphic_allocator< ::std::byte > const & ) : value() {}
+
+	arena_type< Member > value;
+};
+
+
+template< unsigned RANK, typename Member >
+struct _ArenaField< RANK, Member, true >
+{
+	explicit _ArenaField( ::std::pmr::polymorphic_allocator< ::std::byte > const & allocator ) : value( allocator ) {}
+
+	arena_type< Member > value;
+};
+
+
+template< typename Ranks, typename Members >
+struct _ArenaFields;
+
+
+template< unsigned... RANKS, typename... Members >
+struct _ArenaFields< ::std::integer_sequence< unsigned, RANKS... >, MemberList< Members... > >
+	: _ArenaField< RANKS, Members >...
+{
+	explicit _ArenaFields( ::std::pmr::polymorphic_allocator< ::std::byte > const & allocator )
+		: _ArenaField< RANKS, Members >( allocator )... {}
+};
+
+
+
+// Mirror of the introspected members of Implementor whose variable-length members (strings)
+// allocate from the record allocator. Created in an Arena, a record and all its members
+// live in the arena memory and go away with it.
+template< class Implementor >
+class ArenaRecord
+{
+	using Members = typename Implementor::Members;
+	using Fields = _ArenaFields< ::std::make_integer_sequence< unsigned, Members::kSIZE >, Members >;
+
+public:
+	using allocator_type = ::std::pmr::polymorphic_allocator< ::std::byte >;
+
+	explicit ArenaRecord( allocator_type const & allocator = {} ) : _allocator( allocator ), _fields( allocator ) {}
+
+	explicit ArenaRecord( Implementor const & object, allocator_type const & allocator = {} ) : _allocator( allocator ), _fields( allocator ) { assign( object ); }
+
+	ArenaRecord( ArenaRecord const & other, allocator_type const & allocator = {} ) : _allocator( allocator ), _fields( allocator ) { *this = other; }
+
+	ArenaRecord & operator=( ArenaRecord const & other )
+	{
+		for_each_member< Implementor >( [&]( auto rank, auto member )
+		{
+			using Field = _ArenaField< decltype( rank )::value, decltype( member ) >;
+			_arena_assign( static_cast< Field & >( _fields ).value, static_cast< Field const & >( other._fields ).value );
+		} );
+		return *this;
+	}
+
+	void assign( Implementor const & object )
+	{
+		for_each_member< Implementor >( [&]( auto rank, auto member )
+		{
+			using Member = decltype( member );
+			using Field = _ArenaField< decltype( rank )::value, Member >;
+			arena_traits< typename Member::type >::store( static_cast< Field & >( _fields ).value, object.*Member::kPOINTER );
+		} );
+	}
+
+	// Const members of Implementor can only be set at its construction and are left as is.
+	void unpack( Implementor & object ) const
+	{
+		for_each_member< Implementor >( [&]( auto rank, auto member )
+		{
+			using Member = decltype( member );
+			using Field = _ArenaField< decltype( rank )::value, Member >;
+			if constexpr ( ! ::std::is_const< typename Member::type >::value )
+			{
+				arena_traits< typename Member::type >::load( object.*Member::kPOINTER, static_cast< Field const & >( _fields ).value );
+			}
+		} );
+	}
+
+	allocator_type get_allocator() const { return _allocator; }
+
+
+	// Same access as Introspector, with the arena form of member types (::std::pmr::string
+	// for ::std::string).
+	template< unsigned GET_RANK, typename OtherType >
+	OtherType & get()
+	{
+		using Member = typename member_at< GET_RANK, Members >::type;
+		static_assert( ::std::is_same< OtherType, arena_type< Member > >::value, "Bad type" );
+		return static_cast< _ArenaField< GET_RANK, Member > & >( _fields ).value;
+	}
+
+	template< unsigned GET_RANK, typename OtherType >
+	OtherType const & get() const { return const_cast< ArenaRecord & >( *this ).get< GET_RANK, OtherType >(); }
+
+	template< typename OtherType >
+	OtherType & get( unsigned rank )
+	{
+		OtherType * result = nullptr;
+		if ( rank >= Members::kSIZE ) throw EBadRank{};
+
+		for_each_member< Implementor >( [&]( auto member_rank, auto member )
+		{
+			using Member = decltype( member );
+			if constexpr ( ::std::is_same< OtherType, arena_type< Member > >::value )
+			{
+				if ( member_rank == rank ) result = &static_cast< _ArenaField< decltype( member_rank )::value, Member > & >( _fields ).value;
+			}
+		} );
+
+		if ( nullptr == result ) throw EBadType{};
+		return *result;
+	}
+
+	template< typename OtherType >
+	OtherType const & get( unsigned rank ) const { return const_cast< ArenaRecord & >( *this ).get< OtherType >( rank ); }
+
+	template< typename OtherType >
+	OtherType & get( ::std::string const & name ) { return get< OtherType >( _rank( name ) ); }
+
+	template< typename OtherType >
+	OtherType const & get( ::std::string const & name ) const { return get< OtherType >( _rank( name ) ); }
+
+	static ::std::size_t nb_members() { return Members::kSIZE; }
+	static bool has_member( ::std::string const & name ) { return Implementor::has_member( name ); }
+	static char const * member_name( unsigned rank ) { return Implementor::member_name( rank ); }
+
+private:
+	static unsigned _rank( ::std::string const & name )
+	{
+		unsigned result = Members::kSIZE;
+		for_each_member< Implementor >( [&]( auto rank, auto member ) { if ( Members::kSIZE == result && name == decltype( member )::kNAME ) result = rank; } );
+		if ( Members::kSIZE == result ) throw EBadName{};
+		return result;
+	}
+
+	allocator_type _allocator;
+	Fields _fields;
+};
+
+
+
+enum class eArenaMode
+{
+	MONOTONIC	// no reuse until release
+,	POOLED		// destroyed objects return their blocks to size-segregated pools
+};
+
+
+// Memory for request or batch scoped objects. Everything is carved out of chunks taken from
+// upstream, and release() hands all chunks back at once without running any destructor:
+// objects left in the arena must only own arena memory, as ArenaRecord does.
+class Arena
+{
+public:
+	explicit Arena(
+			eArenaMode mode = eArenaMode::MONOTONIC
+		,	::std::size_t initial_size = 64 * 1024
+		,	::std::pmr::memory_resource * upstream = ::std::pmr::get_default_resource()
+		)
+		: _monotonic( initial_size, upstream ), _resource( &_monotonic )
+	{
+		if ( eArenaMode::POOLED == mode ) _resource = &_pool.emplace( &_monotonic );
+	}
+
+	Arena( Arena const & ) = delete;
+	Arena & operator=( Arena const & ) = delete;
+
+	::std::pmr::memory_resource * resource() const { return _resource; }
+	::std::pmr::polymorphic_allocator< ::std::byte > allocator() const { return _resource; }
+
+	// Uses-allocator construction: allocator-aware types, ArenaRecord among them, get the
+	// arena allocator and place their own allocations in the arena too.
+	template< typename T, typename... Args >
+	T * create( Args &&... args )
+	{
+		::std::pmr::polymorphic_allocator< T > allocator( _resource );
+		T * const object = allocator.allocate( 1 );
+
+		try
+		{
+			allocator.construct( object, ::std::forward< Args >( args )... );
+		}
+		catch ( ... )
+		{
+			allocator.deallocate( object, 1 );
+			throw;
+		}
+
+		return object;
+	}
+
+	template< typename T >
+	void destroy( T * object )
+	{
+		object->~T();
+		::std::pmr::polymorphic_allocator< T >( _resource ).deallocate( object, 1 );
+	}
+
+	void release()
+	{
+		if ( _pool ) _pool->release();
+		_monotonic.release();
+	}
+
+private:
+	::std::pmr::monotonic_buffer_resource _monotonic;
+	::std::optional< ::std::pmr::unsynchronized_pool_resource > _pool;
+	::std::pmr::memory_resource * _resource;
+};
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,372 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <typeinfo>
+
+#include "apophenic/Introspect.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+// Members whose bytes fully define their value: runs of them are hashed and compared as raw memory.
+template< typename StorageType >
+using is_bytewise = ::std::has_unique_object_representations< StorageType >;
+
+
+
+inline ::std::uint64_t _hash_mix( ::std::uint64_t a, ::std::uint64_t b )
+{
+#if defined( __SIZEOF_INT128__ )
+	__extension__ using uint128 = unsigned __int128;
+	uint128 const product = static_cast< uint128 >( a ) * b;
+	return static_cast< ::std::uint64_t >( product ) ^ static_cast< ::std::uint64_t >( product >> 64 );
+#else
+	::std::uint64_t const a_lo = a & 0xffffffffull, a_hi = a >> 32;
+	::std::uint64_t const b_lo = b & 0xffffffffull, b_hi = b >> 32;
+	::std::uint64_t const lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+	::std::uint64_t const cross = ( lo_lo >> 32 ) + ( hi_lo & 0xffffffffull ) + lo_hi;
+	::std::uint64_t const high = hi_hi + ( hi_lo >> 32 ) + ( cross >> 32 );
+	return ( ( cross << 32 ) | ( lo_lo & 0xffffffffull ) ) ^ high;
+#endif
+}
+
+
+inline ::std::uint64_t _hash_read( unsigned char const * p, ::std::size_t size )
+{
+	::std::uint64_t value = 0;
+	::std::memcpy( &value, p, size );
+	return value;
+}
+
+
+// Word by word, stopping at the first difference: unlike memcmp, an equal run falls
+// through the way member by member comparisons do.
+inline bool equal_bytes( unsigned char const * a, unsigned char const * b, ::std::size_t size )
+{
+	for ( ; size >= 8; size -= 8, a += 8, b += 8 )
+	{
+		if ( _hash_read( a, 8 ) != _hash_read( b, 8 ) ) return false;
+	}
+
+	return 0 == size || _hash_read( a, size ) == _hash_read( b, size );
+}
+
+
+// Wide multiply-xorshift hash, eight bytes per round.
+inline ::std::uint64_t hash_bytes( void const * data, ::std::size_t size, ::std::uint64_t seed )
+{
+	constexpr ::std::uint64_t kP0 = 0xa0761d6478bd642full;
+	constexpr ::std::uint64_t kP1 = 0xe7037ed1a0b428dbull;
+
+	unsigned char const * p = static_cast< unsigned char const * >( data );
+	::std::uint64_t state = seed ^ kP0;
+
+	for ( ; size >= 16; size -= 16, p += 16 )
+	{
+		state = _hash_mix( _hash_read( p, 8 ) ^ kP1, _hash_read( p + 8, 8 ) ^ state );
+	}
+
+	if ( size > 8 )
+	{
+		state = _hash_mix( _hash_read( p, 8 ) ^ kP1, _hash_read( p + 8, size - 8 ) ^ state );
+	}
+	else if ( size > 0 )
+	{
+		state = _hash_mix( _hash_read( p, size ) ^ kP1, state );
+	}
+
+	return _hash_mix( state ^ kP0, size ^ kP1 );
+}
+
+
+inline ::std::uint64_t hash_combine( ::std::uint64_t seed, ::std::uint64_t value )
+{
+	return _hash_mix( seed ^ 0xe7037ed1a0b428dbull, value ^ 0x8ebc6af09c88c6e3ull );
+}
+
+
+// Tag of a member type derived from its typeid, for schemas that outlive the process.
+template< typename StorageType >
+::std::uint64_t type_tag()
+{
+	char const * const name = typeid( typename ::std::remove_cv< StorageType >::type ).name();
+	return hash_bytes( name, ::std::strlen( name ), 0 );
+}
+
+
+
+template< class Implementor, typename Visitor >
+class _RunSplitter
+{
+public:
+	_RunSplitter( Visitor & visitor ) : _visitor( visitor ), _begin( 0 ), _end( 0 ) {}
+
+	template< unsigned RANK, typename Member >
+	bool operator()( ::std::integral_constant< unsigned, RANK >, Member )
+	{
+		if constexpr ( is_bytewise< typename Member::type >::value )
+		{
+			::std::size_t const offset = member_offset< Implementor, Member >();
+
+			if ( _begin == _end || offset != _end )
+			{
+				if ( false == flush() ) return false;
+				_begin = offset;
+			}
+
+			_end = offset + sizeof( typename Member::type );
+			return true;
+		}
+		else
+		{
+			return flush() && _visitor( Member{} );
+		}
+	}
+
+	bool flush()
+	{
+		bool const keep_going = _begin == _end || _visitor( _begin, _end - _begin );
+		_begin = _end = 0;
+		return keep_going;
+	}
+
+private:
+	Visitor & _visitor;
+	::std::size_t _begin;
+	::std::size_t _end;
+};
+
+
+template< typename Splitter, typename... Members, ::std::size_t... RANKS >
+void _visit_runs( Splitter & splitter, bool & keep_going, MemberList< Members... >, ::std::index_sequence< RANKS... > )
+{
+	static_cast< void >( ( ( keep_going = splitter( ::std::integral_constant< unsigned, RANKS >{}, Members{} ) ) && ... ) );
+}
+
+
+// Visits members in rank order, merging adjacent bytewise members into (offset, size) runs.
+// Visitor returns false to stop early.
+template< class Implementor, typename Visitor >
+bool visit_member_runs( Visitor & visitor )
+{
+	using Members = typename Implementor::Members;
+	_RunSplitter< Implementor, Visitor > splitter( visitor );
+	bool keep_going = true;
+
+	_visit_runs( splitter, keep_going, Members{}, ::std::make_index_sequence< Members::kSIZE >{} );
+	return keep_going && splitter.flush();
+}
+
+
+
+template< class Implementor >
+struct Hash;
+
+
+template< typename StorageType >
+::std::uint64_t hash_value( StorageType const & value )
+{
+	if constexpr ( ::std::is_array< StorageType >::value )
+	{
+		::std::uint64_t state = 0;
+		for ( auto const & element : value ) state = hash_combine( state, hash_value( element ) );
+		return state;
+	}
+	else if constexpr ( is_introspected< StorageType >::value )
+	{
+		return Hash< StorageType >()( value );
+	}
+	else
+	{
+		return ::std::hash< typename ::std::remove_cv< StorageType >::type >()( value );
+	}
+}
+
+
+template< typename StorageType >
+bool equal_value( StorageType const & a, StorageType const & b )
+{
+	if constexpr ( ::std::is_array< StorageType >::value )
+	{
+		return ::std::equal( ::std::begin( a ), ::std::end( a ), ::std::begin( b ), equal_value< typename ::std::remove_extent< StorageType >::type > );
+	}
+	else
+	{
+		return a == b;
+	}
+}
+
+
+template< typename StorageType >
+int compare_value( StorageType const & a, StorageType const & b )
+{
+	if constexpr ( ::std::is_array< StorageType >::value )
+	{
+		for ( ::std::size_t i = 0; i < ::std::extent< StorageType >::value; ++i )
+		{
+			if ( int const result = compare_value( a[i], b[i] ) ) return result;
+		}
+		return 0;
+	}
+	else if constexpr ( ::std::is_integral< StorageType >::value || ::std::is_enum< StorageType >::value )
+	{
+		// Not less and different is greater: one comparison, as with a hand-written chain.
+		return a < b ? -1 : int( a != b );
+	}
+	else
+	{
+		return a < b ? -1 : ( b < a ? 1 : 0 );
+	}
+}
+
+
+
+template< class Implementor >
+struct _HashVisitor
+{
+	Implementor const & _object;
+	::std::uint64_t _state;
+
+	bool operator()( ::std::size_t offset, ::std::size_t size )
+	{
+		_state = hash_bytes( reinterpret_cast< unsigned char const * >( &_object ) + offset, size, _state );
+		return true;
+	}
+
+	template< typename Member >
+	bool operator()( Member )
+	{
+		_state = hash_combine( _state, hash_value< typename Member::type >( _object.*Member::kPOINTER ) );
+		return true;
+	}
+};
+
+
+template< class Implementor >
+struct _EqualVisitor
+{
+	Implementor const & _a;
+	Implementor const & _b;
+
+	bool operator()( ::std::size_t offset, ::std::size_t size )
+	{
+		return equal_bytes(
+				reinterpret_cast< unsigned char const * >( &_a ) + offset
+			,	reinterpret_cast< unsigned char const * >( &_b ) + offset
+			,	size
+			);
+	}
+
+	template< typename Member >
+	bool operator()( Member )
+	{
+		return equal_value< typename Member::type >( _a.*Member::kPOINTER, _b.*Member::kPOINTER );
+	}
+};
+
+
+template< class Implementor >
+struct Hash
+{
+	::std::size_t operator()( Implementor const & object ) const
+	{
+		_HashVisitor< Implementor > visitor{ object, 0 };
+		visit_member_runs< Implementor >( visitor );
+		return static_cast< ::std::size_t >( visitor._state );
+	}
+};
+
+
+template< class Implementor >
+struct EqualTo
+{
+	bool operator()( Implementor const & a, Implementor const & b ) const
+	{
+		_EqualVisitor< Implementor > visitor{ a, b };
+		return visit_member_runs< Implementor >( visitor );
+	}
+};
+
+
+
+// Ordering key modifier: Descending< Member< &T::x > > reverses the order on that member.
+template< typename Member >
+struct Descending {};
+
+
+template< typename Key >
+struct _OrderKey
+{
+	template< class Implementor >
+	static int compare( Implementor const & a, Implementor const & b )
+	{
+		return compare_value< typename Key::type >( a.*Key::kPOINTER, b.*Key::kPOINTER );
+	}
+};
+
+
+template< typename Member >
+struct _OrderKey< Descending< Member > >
+{
+	template< class Implementor >
+	static int compare( Implementor const & a, Implementor const & b )
+	{
+		return -_OrderKey< Member >::compare( a, b );
+	}
+};
+
+
+// Lexicographic ordering over Keys (Member or Descending<Member>), in the given order.
+// With no keys, all members are compared in rank order.
+template< class Implementor, typename... Keys >
+struct Compare
+{
+	static int compare( Implementor const & a, Implementor const & b )
+	{
+		int result = 0;
+		static_cast< void >( ( ( 0 == ( result = _OrderKey< Keys >::compare( a, b ) ) ) && ... ) );
+		return result;
+	}
+};
+
+
+template< class Implementor >
+struct Compare< Implementor >
+{
+	static int compare( Implementor const & a, Implementor const & b )
+	{
+		return _compare( a, b, typename Implementor::Members{} );
+	}
+
+private:
+	template< typename... Members >
+	static int _compare( Implementor const & a, Implementor const & b, MemberList< Members... > )
+	{
+		return Compare< Implementor, Members... >::compare( a, b );
+	}
+};
+
+
+template< class Implementor, typename... Keys >
+struct Less
+{
+	bool operator()( Implementor const & a, Implementor const & b ) const
+	{
+		return Compare< Implementor, Keys... >::compare( a, b ) < 0;
+	}
+};
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "apophenic/Introspect.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+// Copies members of From into the members of To that bear the same name. The mapping is
+// built once per (From, To) pair; adjacent trivially copyable members of the same type on
+// both sides are merged into single block copies. Const members of To are not assigned.
+template< class From, class To >
+class Converter
+{
+	struct Step
+	{
+		::std::size_t from;
+		::std::size_t to;
+		::std::size_t size;
+		void (*copy)( From const &, To & );	// nullptr for raw block copies
+		void (*move)( From &, To & );
+	};
+
+public:
+	static void copy( From const & from, To & to )
+	{
+		unsigned char const * const source = reinterpret_cast< unsigned char const * >( &from );
+		unsigned char * const target = reinterpret_cast< unsigned char * >( &to );
+
+		for ( Step const & step : _plan() )
+		{
+			if ( nullptr == step.copy ) ::std::memcpy( target + step.to, source + step.from, step.size );
+			else step.copy( from, to );
+		}
+	}
+
+	static void move( From && from, To & to )
+	{
+		unsigned char const * const source = reinterpret_cast< unsigned char const * >( &from );
+		unsigned char * const target = reinterpret_cast< unsigned char * >( &to );
+
+		for ( Step const & step : _plan() )
+		{
+			if ( nullptr == step.move ) ::std::memcpy( target + step.to, source + step.from, step.size );
+			else step.move( from, to );
+		}
+	}
+
+	// Bulk form over contiguous arrays: the plan is walked once and each step is applied
+	// to every record, so block copies become tight fixed-size loops.
+	static void copy( From const * from, ::std::size_t count, To * to )
+	{
+		for ( Step const & step : _plan() )
+		{
+			if ( nullptr != step.copy )
+			{
+				for ( ::std::size_t i = 0; i < count; ++i ) step.copy( from[i], to[i] );
+				continue;
+			}
+
+			switch ( step.size )
+			{
+			case 1: _copy_blocks< 1 >( from, count, to, step ); break;
+			case 2: _copy_blocks< 2 >( from, count, to, step ); break;
+			case 4: _copy_blocks< 4 >( from, count, to, step ); break;
+			case 8: _copy_blocks< 8 >( from, count, to, step ); break;
+			case 16: _copy_blocks< 16 >( from, count, to, step ); break;
+			default:
+				for ( ::std::size_t i = 0; i < count; ++i )
+				{
+					::std::memcpy(
+							reinterpret_cast< unsigned char * >( to + i ) + step.to
+						,	reinterpret_cast< unsigned char const * >( from + i ) + step.from
+						,	step.size
+						);
+				}
+			}
+		}
+	}
+
+	template< typename InputIterator, typename OutputIterator >
+	static OutputIterator copy( InputIterator first, InputIterator last, OutputIterator out )
+	{
+		for ( ; first != last; ++first, ++out ) copy( *first, *out );
+		return out;
+	}
+
+	// Number of To members fed from From, and number of copy operations they take.
+	static ::std::size_t nb_mapped() { return _mapping().nb_mapped; }
+	static ::std::size_t nb_steps() { return _plan().size(); }
+
+private:
+	struct Mapping
+	{
+		::std::vector< Step > steps;
+		::std::size_t nb_mapped;
+	};
+
+	template< ::std::size_t SIZE >
+	static void _copy_blocks( From const * from, ::std::size_t count, To * to, Step const & step )
+	{
+		for ( ::std::size_t i = 0; i < count; ++i )
+		{
+			::std::memcpy(
+					reinterpret_cast< unsigned char * >( to + i ) + step.to
+				,	reinterpret_cast< unsigned char const * >( from + i ) + step.from
+				,	SIZE
+				);
+		}
+	}
+
+	template< typename FromMember, typename ToMember >
+	static void _copy_member( From const & from, To & to ) { _assign( to.*ToMember::kPOINTER, from.*FromMember::kPOINTER ); }
+
+	template< typename FromMember, typename ToMember >
+	static void _move_member( From & from, To & to ) { _assign( to.*ToMember::kPOINTER, ::std::move( from.*FromMember::kPOINTER ) ); }
+
+	template< typename Target, typename Source >
+	static void _assign( Target & target, Source && source )
+	{
+		if constexpr ( ::std::is_array< Target >::value )
+		{
+			for ( ::std::size_t i = 0; i < ::std::extent< Target >::value; ++i ) _assign( target[i], ::std::forward< Source >( source )[i] );
+		}
+		else
+		{
+			target = ::std::forward< Source >( source );
+		}
+	}
+
+	template< typename FromType, typename ToType, typename = void >
+	struct _is_braced : ::std::false_type {};
+
+	template< typename FromType, typename ToType >
+	struct _is_braced< FromType, ToType, ::std::void_t< decltype( ToType{ ::std::declval< FromType const & >() } ) > > : ::std::true_type {};
+
+	// Arrays only map to arrays of the same type; other members take any assignment that
+	// would also be valid as a braced, hence non-narrowing, initialization.
+	template< typename FromType, typename ToType >
+	using is_convertible_member = ::std::integral_constant< bool,
+			! ::std::is_const< ToType >::value
+		&&	( ::std::is_array< ToType >::value || ::std::is_array< FromType >::value
+				? ::std::is_same< typename ::std::remove_cv< FromType >::type, ToType >::value
+				: ::std::is_assignable< ToType &, FromType const & >::value && _is_braced< FromType, ToType >::value )
+		>;
+
+	static Mapping _build()
+	{
+		Mapping mapping{ {}, 0 };
+
+		for_each_member< To >( [&]( auto, auto to_member )
+		{
+			using ToMember = typename ::std::decay< decltype( to_member ) >::type;
+			using ToType = typename ToMember::type;
+
+			for_each_member< From >( [&]( auto, auto from_member )
+			{
+				using FromMember = decltype( from_member );
+				using FromType = typename FromMember::type;
+
+				if constexpr ( is_convertible_member< FromType, ToType >::value )
+				{
+					if ( ::std::string( FromMember::kNAME ) != ToMember::kNAME ) return;
+
+					constexpr bool kRAW =
+							::std::is_same< typename ::std::remove_cv< FromType >::type, ToType >::value
+						&&	::std::is_trivially_copyable< ToType >::value;
+
+					mapping.steps.push_back( Step{
+							member_offset< From, FromMember >()
+						,	member_offset< To, ToMember >()
+						,	sizeof( ToType )
+						,	kRAW ? nullptr : &_copy_member< FromMember, ToMember >
+						,	kRAW ? nullptr : &_move_member< FromMember, ToMember >
+						} );
+					++mapping.nb_mapped;
+				}
+			} );
+		} );
+
+		::std::sort( mapping.steps.begin(), mapping.steps.end(), []( Step const & a, Step const & b ) { return a.to < b.to; } );
+
+		::std::vector< Step > merged;
+
+		for ( Step const & step : mapping.steps )
+		{
+			if (	false == merged.empty()
+				&&	nullptr == step.copy
+				&&	nullptr == merged.back().copy
+				&&	merged.back().from + merged.back().size == step.from
+				&&	merged.back().to + merged.back().size == step.to
+				)
+			{
+				merged.back().size += step.size;
+			}
+			else
+			{
+				merged.push_back( step );
+			}
+		}
+
+		mapping.steps = ::std::move( merged );
+		return mapping;
+	}
+
+	static Mapping const & _mapping()
+	{
+		static Mapping const mapping = _build();
+		return mapping;
+	}
+
+	static ::std::vector< Step > const & _plan() { return _mapping().steps; }
+};
+
+
+template< class To, class From >
+void convert( From const & from, To & to ) { Converter< From, To >::copy( from, to ); }
+
+template< class To, class From >
+To convert( From const & from )
+{
+	To to{};
+	Converter< From, To >::copy( from, to );
+	return to;
+}
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+
+#include "apophenic/Introspect.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+// Drop-in alternative to Introspector for wide records: a single class whatever the number
+// of members, with lookups unrolled by fold expressions instead of a recursive chain of
+// bases. Instantiation depth stays constant, and build time and symbol size grow linearly.
+// parent_introspector() has no equivalent, everything else is the same.
+template< class Implementor, typename... AllMembers >
+class FlatIntrospector
+{
+	static_assert( sizeof...( AllMembers ) > 0, "No member" );
+
+public:
+	using Introspector = FlatIntrospector;
+	using Members = MemberList< AllMembers... >;
+	using FrontMember = typename member_at< 0, Members >::type;
+	using MemberType = typename FrontMember::type;
+
+
+	Introspector & introspector() { return *this; }
+	Introspector const & introspector() const { return *this; }
+
+
+	typename member_access<MemberType>::type front_member() { return FrontMember::template get< FlatIntrospector, Implementor >( this ); }
+	typename member_read<MemberType>::type front_member() const { return FrontMember::template get< FlatIntrospector, Implementor >( this ); }
+
+
+	static char const * front_member_name() { return FrontMember::kNAME; }
+
+
+	template< typename OtherType >
+	typename member_read<OtherType>::type get( ::std::string const & name ) const
+		{ return _dyn_get<OtherType>( this, _checked_rank( name ) ); }
+
+	template< typename OtherType >
+	typename member_access<OtherType>::type get( ::std::string const & name )
+		{ return _dyn_get<OtherType>( this, _checked_rank( name ) ); }
+
+	template< typename OtherType >
+	typename member_read<OtherType>::type get( unsigned rank ) const
+		{ return _dyn_get<OtherType>( this, _checked_rank( rank ) ); }
+
+	template< typename OtherType >
+	typename member_access<OtherType>::type get( unsigned rank )
+		{ return _dyn_get<OtherType>( this, _checked_rank( rank ) ); }
+
+
+	template< unsigned GET_RANK, typename OtherType >
+	typename member_read<OtherType>::type get() const
+		{ return _sta_get<GET_RANK, OtherType>( this ); }
+
+	template< unsigned GET_RANK, typename OtherType >
+	typename member_access<OtherType>::type get()
+		{ return _sta_get<GET_RANK, OtherType>( this ); }
+
+
+	static ::std::size_t nb_members() { return sizeof...( AllMembers ); }
+
+
+	static bool has_member( ::std::string const & name )
+	{
+		return _rank( name ) < sizeof...( AllMembers );
+	}
+
+
+	static char const * member_name( unsigned rank )
+	{
+		char const * result = nullptr;
+		unsigned i = 0;
+		static_cast< void >( ( ( i++ == rank && ( result = AllMembers::kNAME, true ) ) || ... ) );
+
+		if ( nullptr == result ) throw EBadRank{};
+		return result;
+	}
+
+
+	::std::type_info const & member_type( ::std::string const & name ) const
+	{
+		return _type( _checked_rank( name ) );
+	}
+
+
+	::std::type_info const & member_type( unsigned rank ) const
+	{
+		return _type( _checked_rank( rank ) );
+	}
+
+
+protected:
+	static unsigned _rank( ::std::string const & name )
+	{
+		unsigned rank = 0;
+		static_cast< void >( ( ( AllMembers::kNAME == name || ( ++rank, false ) ) || ... ) );
+		return rank;
+	}
+
+
+	static unsigned _checked_rank( ::std::string const & name )
+	{
+		unsigned const rank = _rank( name );
+		if ( rank >= sizeof...( AllMembers ) ) throw EBadName{};
+		return rank;
+	}
+
+
+	static unsigned _checked_rank( unsigned rank )
+	{
+		if ( rank >= sizeof...( AllMembers ) ) throw EBadRank{};
+		return rank;
+	}
+
+
+	static ::std::type_info const & _type( unsigned rank )
+	{
+		::std::type_info const * result = nullptr;
+		unsigned i = 0;
+		static_cast< void >( ( ( i++ == rank && ( result = &typeid( typename AllMembers::type ), true ) ) || ... ) );
+		return *result;
+	}
+
+
+	template< typename OtherType, typename Member, typename This >
+	static auto _address( This * _this )
+	{
+		using Pointer = typename ::std::conditional< is_this_const<This>::value, OtherType const *, OtherType * >::type;
+
+		if constexpr ( ::std::is_same< OtherType, typename Member::type >::value )
+		{
+			return Pointer( &( static_cast< typename ::std::conditional< is_this_const<This>::value, Implementor const *, Implementor * >::type >( _this )->*Member::kPOINTER ) );
+		}
+		else
+		{
+			return Pointer( nullptr );
+		}
+	}
+
+
+	template< typename OtherType, typename This >
+	static
+	typename get_result<This,OtherType>::type _dyn_get( This * _this, unsigned rank )
+	{
+		decltype( _address< OtherType, FrontMember >( _this ) ) result = nullptr;
+		unsigned i = 0;
+		static_cast< void >( ( ( i++ == rank && ( result = _address< OtherType, AllMembers >( _this ), true ) ) || ... ) );
+
+		if ( nullptr == result ) throw EBadType{};
+		return *result;
+	}
+
+
+	template< unsigned GET_RANK, typename OtherType, typename This >
+	static
+	typename get_result<This,OtherType>::type _sta_get( This * _this )
+	{
+		static_assert( GET_RANK < sizeof...( AllMembers ), "Bad rank" );
+		using Member = typename member_at< GET_RANK, Members >::type;
+		static_assert( ::std::is_same<OtherType, typename Member::type>::value, "Bad type" );
+		return Member::template get< This, Implementor >( _this );
+	}
+};
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "apophenic/Introspect.hxx"
+#include "apophenic/IntrospectCompare.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+struct EDuplicateKey : Error {};
+struct EBadId : Error {};
+
+
+
+// Index kinds over one member: Unique< Member< &Order::id > >, Multi< Member< &Order::venue > >.
+template< typename Member >
+struct Unique
+{
+	using member = Member;
+	static constexpr bool kUNIQUE = true;
+};
+
+
+template< typename Member >
+struct Multi
+{
+	using member = Member;
+	static constexpr bool kUNIQUE = false;
+};
+
+
+
+// Open-addressing table of object ids with linear probing and backward-shift erasure, so
+// there are no tombstones. Entries keep the low 32 bits of the key hash, which settles most
+// mismatching probes without touching the objects.
+template< typename Index >
+class _HashIndex
+{
+public:
+	using Member = typename Index::member;
+	using KeyType = typename Member::type;
+	using Id = ::std::uint32_t;
+
+	static constexpr Id kEMPTY = ~Id( 0 );
+
+	static ::std::uint64_t hash( KeyType const & key ) { return hash_combine( 0, hash_value< KeyType >( key ) ); }
+
+	template< typename Objects, typename Function >
+	void for_each_equal( KeyType const & key, ::std::uint64_t hash, Objects const & objects, Function && function ) const
+	{
+		if ( _entries.empty() ) return;
+
+		::std::uint32_t const tag = static_cast< ::std::uint32_t >( hash );
+
+		for ( ::std::size_t slot = tag & _mask; kEMPTY != _entries[ slot ].id; slot = ( slot + 1 ) & _mask )
+		{
+			Entry const & entry = _entries[ slot ];
+
+			if ( tag == entry.tag && equal_value< KeyType >( (*objects[ entry.id ]).*Member::kPOINTER, key ) )
+			{
+				if ( false == function( entry.id ) ) return;
+			}
+		}
+	}
+
+	template< typename Objects >
+	Id find( KeyType const & key, ::std::uint64_t hash, Objects const & objects ) const
+	{
+		Id result = kEMPTY;
+		for_each_equal( key, hash, objects, [&result]( Id id ) { result = id; return false; } );
+		return result;
+	}
+
+	void insert( Id id, ::std::uint64_t hash )
+	{
+		if ( ( _size + 1 ) * 4 > _entries.size() * 3 ) _grow();
+
+		::std::uint32_t const tag = static_cast< ::std::uint32_t >( hash );
+		::std::size_t slot = tag & _mask;
+
+		while ( kEMPTY != _entries[ slot ].id ) slot = ( slot + 1 ) & _mask;
+
+		_entries[ slot ] = Entry{ id, tag };
+		++_size;
+	}
+
+	void erase( Id id, ::std::uint64_t hash )
+	{
+		::std::size_t hole = static_cast< ::std::uint32_t >( hash ) & _mask;
+
+		while ( id != _entries[ hole ].id ) hole = ( hole + 1 ) & _mask;
+
+		for ( ::std::size_t slot = ( hole + 1 ) & _mask; kEMPTY != _entries[ slot ].id; slot = ( slot + 1 ) & _mask )
+		{
+			::std::size_t const home = _entries[ slot ].tag & _mask;
+
+			// Entry may move back into the hole unless its home lies cyclically in ( hole, slot ].
+			if ( ( ( slot - home ) & _mask ) >= ( ( slot - hole ) & _mask ) )
+			{
+				_entries[ hole ] = _entries[ slot ];
+				hole = slot;
+			}
+		}
+
+		_entries[ hole ].id = kEMPTY;
+		--_size;
+	}
+
+	void clear()
+	{
+		_entries.clear();
+		_mask = 0;
+		_size = 0;
+	}
+
+	::std::size_t capacity() const { return _entries.size(); }
+
+private:
+	struct Entry
+	{
+		Id id;
+		::std::uint32_t tag;
+	};
+
+	void _grow()
+	{
+		::std::vector< Entry > entries( _entries.empty() ? 16 : _entries.size() * 2, Entry{ kEMPTY, 0 } );
+		entries.swap( _entries );
+		_mask = _entries.size() - 1;
+		_size = 0;
+
+		for ( Entry const & entry : entries )
+		{
+			if ( kEMPTY != entry.id ) insert( entry.id, entry.tag );
+		}
+	}
+
+	::std::vector< Entry > _entries;
+	::std::size_t _mask = 0;
+	::std::size_t _size = 0;
+};
+
+
+
+// Owns introspected objects in a single slot array and keeps any number of member indexes
+// over it; indexes only hold object ids, so every indexed field costs eight bytes per slot
+// of its table and no copy of the objects. Ids stay valid until the object is erased.
+template< class Implementor, typename... Indexes >
+class IndexedCollection
+{
+public:
+	using Id = ::std::uint32_t;
+
+	static constexpr Id npos = ~Id( 0 );
+
+	// Throws EDuplicateKey, leaving the collection untouched, if a unique index already
+	// holds one of the object keys.
+	Id insert( Implementor object )
+	{
+		::std::uint64_t hashes[ sizeof...( Indexes ) + 1 ];
+		_check( object, npos, hashes, ::std::index_sequence_for< Indexes... >() );
+
+		Id id;
+
+		if ( _free.empty() )
+		{
+			id = static_cast< Id >( _objects.size() );
+			_objects.emplace_back( ::std::move( object ) );
+		}
+		else
+		{
+			id = _free.back();
+			_free.pop_back();
+			_objects[ id ].emplace( ::std::move( object ) );
+		}
+
+		_insert( id, hashes, ::std::index_sequence_for< Indexes... >() );
+		return id;
+	}
+
+	// Replaces the object. Throws EDuplicateKey like insert, leaving the collection untouched.
+	// If assigning the object throws, it stays indexed under the keys the assignment left.
+	void replace( Id id, Implementor object )
+	{
+		::std::uint64_t old_hashes[ sizeof...( Indexes ) + 1 ];
+		::std::uint64_t hashes[ sizeof...( Indexes ) + 1 ];
+		_check( _at( id ), id, old_hashes, ::std::index_sequence_for< Indexes... >() );
+		_check( object, id, hashes, ::std::index_sequence_for< Indexes... >() );
+
+		// Erasing first leaves room in every table, so the inserts below never grow one.
+		_erase( id, old_hashes, ::std::index_sequence_for< Indexes... >() );
+
+		try
+		{
+			*_objects[ id ] = ::std::move( object );
+		}
+		catch ( ... )
+		{
+			_hash( *_objects[ id ], hashes, ::std::index_sequence_for< Indexes... >() );
+			_insert( id, hashes, ::std::index_sequence_for< Indexes... >() );
+			throw;
+		}
+
+		_insert( id, hashes, ::std::index_sequence_for< Indexes... >() );
+	}
+
+	// Applies modifier to a copy of the object, then replaces it.
+	template< typename Modifier >
+	void update( Id id, Modifier && modifier )
+	{
+		Implementor object = _at( id );
+		modifier( object );
+		replace( id, ::std::move( object ) );
+	}
+
+	void erase( Id id )
+	{
+		::std::uint64_t hashes[ sizeof...( Indexes ) + 1 ];
+		_check( _at( id ), id, hashes, ::std::index_sequence_for< Indexes... >() );
+		_erase( id, hashes, ::std::index_sequence_for< Indexes... >() );
+
+		_objects[ id ].reset();
+		_free.push_back( id );
+	}
+
+	void clear()
+	{
+		_objects.clear();
+		_free.clear();
+		::std::apply( []( auto &... indexes ) { ( indexes.clear(), ... ); }, _indexes );
+	}
+
+	bool contains( Id id ) const { return id < _objects.size() && _objects[ id ].has_value(); }
+	::std::size_t size() const { return _objects.size() - _free.size(); }
+
+	Implementor const & operator[]( Id id ) const { return _at( id ); }
+
+	template< typename Function >
+	void for_each( Function && function ) const
+	{
+		for ( Id id = 0; id < _objects.size(); ++id )
+		{
+			if ( _objects[ id ] ) function( id, *_objects[ id ] );
+		}
+	}
+
+	// Lookups by indexed member. find returns npos when no object has the key.
+	template< typename Member >
+	Id find( typename Member::type const & key ) const
+	{
+		auto const & index = _index< Member >();
+		return index.find( key, index.hash( key ), _objects );
+	}
+
+	template< typename Member, typename Function >
+	void for_each_equal( typename Member::type const & key, Function && function ) const
+	{
+		auto const & index = _index< Member >();
+		index.for_each_equal( key, index.hash( key ), _objects, [&]( Id id ) { function( id, *_objects[ id ] ); return true; } );
+	}
+
+	template< typename Member >
+	::std::size_t count( typename Member::type const & key ) const
+	{
+		::std::size_t result = 0;
+		for_each_equal< Member >( key, [&result]( Id, Implementor const & ) { ++result; } );
+		return result;
+	}
+
+private:
+	template< typename Member >
+	static constexpr ::std::size_t _rank()
+	{
+		::std::size_t rank = sizeof...( Indexes ), i = 0;
+		static_cast< void >( ( ( rank = ::std::is_same< Member, typename Indexes::member >::value && rank == sizeof...( Indexes ) ? i : rank, ++i ), ... ) );
+		return rank;
+	}
+
+	template< typename Member >
+	auto const & _index() const
+	{
+		static_assert( _rank< Member >() < sizeof...( Indexes ), "Member is not indexed" );
+		return ::std::get< _rank< Member >() >( _indexes );
+	}
+
+	Implementor const & _at( Id id ) const
+	{
+		if ( false == contains( id ) ) throw EBadId{};
+		return *_objects[ id ];
+	}
+
+	template< ::std::size_t... RANKS >
+	void _check( Implementor const & object, Id self, ::std::uint64_t * hashes, ::std::index_sequence< RANKS... > ) const
+	{
+		static_cast< void >( ( _check_one< RANKS >( object, self, hashes[ RANKS ] ), ... ) );
+	}
+
+	template< ::std::size_t RANK >
+	bool _check_one( Implementor const & object, Id self, ::std::uint64_t & hash ) const
+	{
+		using Index = typename ::std::tuple_element< RANK, ::std::tuple< Indexes... > >::type;
+		using Member = typename Index::member;
+
+		auto const & index = ::std::get< RANK >( _indexes );
+		auto const & key = object.*Member::kPOINTER;
+		hash = index.hash( key );
+
+		if constexpr ( Index::kUNIQUE )
+		{
+			Id const other = index.find( key, hash, _objects );
+			if ( npos != other && self != other ) throw EDuplicateKey{};
+		}
+
+		return true;
+	}
+
+	template< ::std::size_t... RANKS >
+	void _hash( Implementor const & object, ::std::uint64_t * hashes, ::std::index_sequence< RANKS... > ) const
+	{
+		static_cast< void >( ( ( hashes[ RANKS ] = ::std::get< RANKS >( _indexes ).hash( object.*::std::tuple_element< RANKS, ::std::tuple< Indexes... > >::type::member::kPOINTER ) ), ... ) );
+	}
+
+	template< ::std::size_t... RANKS >
+	void _insert( Id id, ::std::uint64_t const * hashes, ::std::index_sequence< RANKS... > )
+	{
+		static_cast< void >( ( ::std::get< RANKS >( _indexes ).insert( id, hashes[ RANKS ] ), ... ) );
+	}
+
+	template< ::std::size_t... RANKS >
+	void _erase( Id id, ::std::uint64_t const * hashes, ::std::index_sequence< RANKS... > )
+	{
+		static_cast< void >( ( ::std::get< RANKS >( _indexes ).erase( id, hashes[ RANKS ] ), ... ) );
+	}
+
+	::std::vector< ::std::optional< Implementor > > _objects;
+	::std::vector< Id > _free;
+	::std::tuple< _HashIndex< Indexes >... > _indexes;
+};
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "apophenic/Introspect.hxx"
+#include "apophenic/IntrospectCompare.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+struct EKeyTooLong : Error {};
+struct EBadKey : Error {};
+
+
+
+// Byte sinks and sources of key codecs. Descending parts are written with every byte
+// complemented, which reverses their order under memcmp.
+class _KeySink
+{
+public:
+	_KeySink( unsigned char * buffer, ::std::size_t capacity ) : _cursor( buffer ), _end( buffer + capacity ), _mask( 0 ) {}
+
+	void put( unsigned char byte )
+	{
+		if ( _cursor == _end ) throw EKeyTooLong{};
+		*_cursor++ = byte ^ _mask;
+	}
+
+	void mask( unsigned char mask ) { _mask = mask; }
+	unsigned char * cursor() const { return _cursor; }
+
+private:
+	unsigned char * _cursor;
+	unsigned char * const _end;
+	unsigned char _mask;
+};
+
+
+class _KeySource
+{
+public:
+	_KeySource( unsigned char const * data, ::std::size_t size ) : _cursor( data ), _end( data + size ), _mask( 0 ) {}
+
+	unsigned char get()
+	{
+		if ( _cursor == _end ) throw EBadKey{};
+		return *_cursor++ ^ _mask;
+	}
+
+	void mask( unsigned char mask ) { _mask = mask; }
+	unsigned char const * cursor() const { return _cursor; }
+
+private:
+	unsigned char const * _cursor;
+	unsigned char const * const _end;
+	unsigned char _mask;
+};
+
+
+
+// Order-preserving encoding of a member type. Integers are big-endian with the sign bit
+// flipped, floating point values have all bits flipped when negative and the sign bit
+// otherwise, strings end with 00 01 and escape their 00 bytes as 00 FF.
+template< typename StorageType, typename = void >
+struct key_traits;
+
+
+template< typename StorageType >
+struct key_traits< StorageType, typename ::std::enable_if< ::std::is_integral< StorageType >::value || ::std::is_enum< StorageType >::value >::type >
+{
+	using Integral = typename ::std::conditional< ::std::is_enum< StorageType >::value, ::std::underlying_type< StorageType >, ::std::common_type< StorageType > >::type::type;
+	using Unsigned = typename ::std::make_unsigned< typename ::std::conditional< ::std::is_same< Integral, bool >::value, unsigned char, Integral >::type >::type;
+
+	static constexpr ::std::size_t kSIZE = sizeof( StorageType );
+	static constexpr Unsigned kSIGN = ::std::is_signed< Integral >::value ? Unsigned( Unsigned( 1 ) << ( kSIZE * 8 - 1 ) ) : Unsigned( 0 );
+
+	static void encode( StorageType value, _KeySink & sink )
+	{
+		Unsigned const bits = static_cast< Unsigned >( value ) ^ kSIGN;
+		for ( ::std::size_t i = kSIZE; i-- > 0; ) sink.put( static_cast< unsigned char >( bits >> ( i * 8 ) ) );
+	}
+
+	static void decode( _KeySource & source, StorageType & value )
+	{
+		Unsigned bits = 0;
+		for ( ::std::size_t i = 0; i < kSIZE; ++i ) bits = static_cast< Unsigned >( ( bits << 8 ) | source.get() );
+		value = static_cast< StorageType >( static_cast< Integral >( bits ^ kSIGN ) );
+	}
+};
+
+
+template< typename StorageType >
+struct key_traits< StorageType, typename ::std::enable_if< ::std::is_floating_point< StorageType >::value && ( 4 == sizeof( StorageType ) || 8 == sizeof( StorageType ) ) >::type >
+{
+	using Bits = typename ::std::conditional< 4 == sizeof( StorageType ), ::std::uint32_t, ::std::uint64_t >::type;
+
+	static constexpr Bits kSIGN = Bits( 1 ) << ( sizeof( Bits ) * 8 - 1 );
+
+	static void encode( StorageType value, _KeySink & sink )
+	{
+		Bits bits;
+		::std::memcpy( &bits, &value, sizeof( bits ) );
+		key_traits< Bits >::encode( ( bits & kSIGN ) ? Bits( ~bits ) : Bits( bits | kSIGN ), sink );
+	}
+
+	static void decode( _KeySource & source, StorageType & value )
+	{
+		Bits bits;
+		key_traits< Bits >::decode( source, bits );
+		bits = ( bits & kSIGN ) ? Bits( bits & ~kSIGN ) : Bits( ~bits );
+		::std::memcpy( &value, &bits, sizeof( bits ) );
+	}
+};
+
+
+template<>
+struct key_traits< ::std::string >
+{
+	static void encode( ::std::string const & value, _KeySink & sink )
+	{
+		for ( char const c : value )
+		{
+			sink.put( static_cast< unsigned char >( c ) );
+			if ( '\0' == c ) sink.put( 0xff );
+		}
+		sink.put( 0x00 );
+		sink.put( 0x01 );
+	}
+
+	static void decode( _KeySource & source, ::std::string & value )
+	{
+		value.clear();
+
+		for ( ;; )
+		{
+			unsigned char const byte = source.get();
+
+			if ( 0x00 == byte )
+			{
+				unsigned char const escape = source.get();
+				if ( 0x01 == escape ) return;
+				if ( 0xff != escape ) throw EBadKey{};
+			}
+
+			value.push_back( static_cast< char >( byte ) );
+		}
+	}
+};
+
+
+template< typename Element, ::std::size_t SIZE >
+struct key_traits< Element[ SIZE ] >
+{
+	static void encode( Element const ( &value )[ SIZE ], _KeySink & sink )
+	{
+		for ( Element const & element : value ) key_traits< Element >::encode( element, sink );
+	}
+
+	static void decode( _KeySource & source, Element ( &value )[ SIZE ] )
+	{
+		for ( Element & element : value ) key_traits< Element >::decode( source, element );
+	}
+};
+
+
+template< typename Key >
+struct _KeyPart
+{
+	using Member = Key;
+	static constexpr unsigned char kMASK = 0x00;
+};
+
+
+template< typename Member_ >
+struct _KeyPart< Descending< Member_ > >
+{
+	using Member = Member_;
+	static constexpr unsigned char kMASK = 0xff;
+};
+
+
+
+// Flat keys over Keys (Member or Descending<Member>) whose memcmp order is the order of
+// the members, in the given sequence. With no keys, all members are used in rank order.
+// A codec over the leading keys only gives the prefixes that bound range scans.
+template< class Implementor, typename... Keys >
+struct KeyCodec
+{
+	// Writes the key into buffer and returns its size. Throws EKeyTooLong.
+	static ::std::size_t encode( Implementor const & object, unsigned char * buffer, ::std::size_t capacity )
+	{
+		_KeySink sink( buffer, capacity );
+		static_cast< void >( ( _encode< Keys >( object, sink ), ... ) );
+		return sink.cursor() - buffer;
+	}
+
+	// Reads the key back into the members it covers and returns its size. Const members
+	// are decoded but left as is. Throws EBadKey.
+	static ::std::size_t decode( void const * data, ::std::size_t size, Implementor & object )
+	{
+		_KeySource source( static_cast< unsigned char const * >( data ), size );
+		static_cast< void >( ( _decode< Keys >( source, object ), ... ) );
+		return source.cursor() - static_cast< unsigned char const * >( data );
+	}
+
+private:
+	template< typename Key >
+	static bool _encode( Implementor const & object, _KeySink & sink )
+	{
+		using Member = typename _KeyPart< Key >::Member;
+		sink.mask( _KeyPart< Key >::kMASK );
+		key_traits< typename ::std::remove_const< typename Member::type >::type >::encode( object.*Member::kPOINTER, sink );
+		return true;
+	}
+
+	template< typename Key >
+	static bool _decode( _KeySource & source, Implementor & object )
+	{
+		using Member = typename _KeyPart< Key >::Member;
+		using StorageType = typename ::std::remove_const< typename Member::type >::type;
+		source.mask( _KeyPart< Key >::kMASK );
+
+		if constexpr ( ::std::is_const< typename Member::type >::value )
+		{
+			StorageType ignored;
+			key_traits< StorageType >::decode( source, ignored );
+		}
+		else
+		{
+			key_traits< StorageType >::decode( source, object.*Member::kPOINTER );
+		}
+
+		return true;
+	}
+};
+
+
+template< class Implementor >
+struct KeyCodec< Implementor >
+{
+	static ::std::size_t encode( Implementor const & object, unsigned char * buffer, ::std::size_t capacity )
+		{ return _All< typename Implementor::Members >::encode( object, buffer, capacity ); }
+
+	static ::std::size_t decode( void const * data, ::std::size_t size, Implementor & object )
+		{ return _All< typename Implementor::Members >::decode( data, size, object ); }
+
+private:
+	template< typename Members >
+	struct _All;
+
+	template< typename... Members >
+	struct _All< MemberList< Members... > > : KeyCodec< Implementor, Members... > {};
+};
+
+
+
+// Key held on the stack, ordered by memcmp like the store orders it.
+template< ::std::size_t CAPACITY = 256 >
+class KeyBuffer
+{
+public:
+	KeyBuffer() : _size( 0 ) {}
+
+	template< typename Codec, class Implementor >
+	static KeyBuffer encode( Implementor const & object )
+	{
+		KeyBuffer key;
+		key._size = Codec::encode( object, key._data, CAPACITY );
+		return key;
+	}
+
+	unsigned char const * data() const { return _data; }
+	::std::size_t size() const { return _size; }
+
+	int compare( KeyBuffer const & other ) const
+	{
+		int const result = ::std::memcmp( _data, other._data, _size < other._size ? _size : other._size );
+		return 0 != result ? result : ( _size < other._size ? -1 : ( other._size < _size ? 1 : 0 ) );
+	}
+
+	bool operator<( KeyBuffer const & other ) const { return compare( other ) < 0; }
+	bool operator==( KeyBuffer const & other ) const { return 0 == compare( other ); }
+
+private:
+	unsigned char _data[ CAPACITY ];
+	::std::size_t _size;
+};
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,435 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "apophenic/Introspect.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+template< typename Members >
+struct _MemberSizes;
+
+template< typename... Members >
+struct _MemberSizes< MemberList< Members... > >
+{
+	static constexpr ::std::array< ::std::size_t, sizeof...( Members ) > kSIZES{ { sizeof( typename Members::type )... } };
+	static constexpr ::std::array< ::std::size_t, sizeof...( Members ) > kALIGNMENTS{ { alignof( typename Members::type )... } };
+};
+
+
+template< ::std::size_t N >
+constexpr ::std::array< unsigned, N > _order_by_alignment( ::std::array< ::std::size_t, N > const & alignments )
+{
+	::std::array< unsigned, N > order{};
+	for ( unsigned i = 0; i < N; ++i ) order[i] = i;
+
+	// stable insertion sort, largest alignment first
+	for ( ::std::size_t i = 1; i < N; ++i )
+	{
+		for ( ::std::size_t j = i; j > 0 && alignments[ order[j - 1] ] < alignments[ order[j] ]; --j )
+		{
+			unsigned const tmp = order[j];
+			order[j] = order[j - 1];
+			order[j - 1] = tmp;
+		}
+	}
+
+	return order;
+}
+
+
+template< ::std::size_t N >
+constexpr ::std::array< ::std::size_t, N > _packed_offsets(
+		::std::array< ::std::size_t, N > const & sizes
+	,	::std::array< ::std::size_t, N > const & alignments
+	)
+{
+	::std::array< unsigned, N > const order = _order_by_alignment( alignments );
+	::std::array< ::std::size_t, N > offsets{};
+	::std::size_t end = 0;
+
+	for ( ::std::size_t i = 0; i < N; ++i )
+	{
+		::std::size_t const rank = order[i];
+		offsets[ rank ] = ( end + alignments[ rank ] - 1 ) / alignments[ rank ] * alignments[ rank ];
+		end = offsets[ rank ] + sizes[ rank ];
+	}
+
+	return offsets;
+}
+
+
+
+// Layout of the introspected members of Implementor. Sizes, alignments and the packed
+// layout are constant expressions; offsets inside Implementor come from member_offset.
+template< class Implementor >
+struct Layout
+{
+	using Members = typename Implementor::Members;
+	static constexpr ::std::size_t kNB_MEMBERS = Members::kSIZE;
+
+	static constexpr ::std::array< ::std::size_t, kNB_MEMBERS > kSIZES = _MemberSizes< Members >::kSIZES;
+	static constexpr ::std::array< ::std::size_t, kNB_MEMBERS > kALIGNMENTS = _MemberSizes< Members >::kALIGNMENTS;
+
+	static constexpr ::std::size_t kPAYLOAD = [] {
+		::std::size_t total = 0;
+		for ( ::std::size_t size : kSIZES ) total += size;
+		return total;
+	}();
+
+	static constexpr ::std::size_t kPACKED_ALIGNMENT = [] {
+		::std::size_t alignment = 1;
+		for ( ::std::size_t a : kALIGNMENTS ) alignment = a > alignment ? a : alignment;
+		return alignment;
+	}();
+
+	static constexpr ::std::array< ::std::size_t, kNB_MEMBERS > kPACKED_OFFSETS = _packed_offsets( kSIZES, kALIGNMENTS );
+
+	static constexpr ::std::size_t kPACKED_SIZE = [] {
+		::std::size_t end = 0;
+		for ( ::std::size_t i = 0; i < kNB_MEMBERS; ++i ) end = ::std::max( end, kPACKED_OFFSETS[i] + kSIZES[i] );
+		return ( end + kPACKED_ALIGNMENT - 1 ) / kPACKED_ALIGNMENT * kPACKED_ALIGNMENT;
+	}();
+
+
+	static ::std::array< ::std::size_t, kNB_MEMBERS > offsets()
+	{
+		::std::array< ::std::size_t, kNB_MEMBERS > result{};
+		for_each_member< Implementor >( [&]( auto rank, auto member ) { result[ rank ] = member_offset< Implementor, decltype( member ) >(); } );
+		return result;
+	}
+};
+
+
+
+struct MemberLayout
+{
+	char const * name;
+	unsigned rank;
+	::std::size_t offset;
+	::std::size_t size;
+	::std::size_t alignment;
+	::std::size_t padding;	// hole between this member and the next one, or the end of the object
+};
+
+
+// Members of Implementor in memory order, with the padding following each of them.
+template< class Implementor >
+::std::vector< MemberLayout > layout_report()
+{
+	using L = Layout< Implementor >;
+	auto const offsets = L::offsets();
+	::std::vector< MemberLayout > report;
+
+	for ( unsigned rank = 0; rank < L::kNB_MEMBERS; ++rank )
+	{
+		report.push_back( MemberLayout{ Implementor::member_name( rank ), rank, offsets[ rank ], L::kSIZES[ rank ], L::kALIGNMENTS[ rank ], 0 } );
+	}
+
+	::std::sort( report.begin(), report.end(), []( MemberLayout const & a, MemberLayout const & b ) { return a.offset < b.offset; } );
+
+	for ( ::std::size_t i = 0; i < report.size(); ++i )
+	{
+		::std::size_t const next = i + 1 < report.size() ? report[ i + 1 ].offset : sizeof( Implementor );
+		::std::size_t const end = report[i].offset + report[i].size;
+		report[i].padding = next > end ? next - end : 0;
+	}
+
+	return report;
+}
+
+
+template< class Implementor >
+::std::size_t padding_bytes()
+{
+	::std::size_t total = 0;
+	for ( MemberLayout const & member : layout_report< Implementor >() ) total += member.padding;
+	return total;
+}
+
+
+
+// Mirror of the introspected members of Implementor, stored by decreasing alignment so
+// that padding only remains at the end. Offers the same name/rank access as Introspector,
+// and conversions from and to Implementor.
+template< class Implementor >
+class Packed
+{
+	using L = Layout< Implementor >;
+	using Members = typename L::Members;
+
+	template< typename StorageType >
+	using stored = typename ::std::remove_const< StorageType >::type;
+
+	template< typename... AllMembers >
+	static constexpr bool _nothrow_move( MemberList< AllMembers... > )
+	{
+		return ( ::std::is_nothrow_move_constructible< typename ::std::remove_all_extents< stored< typename AllMembers::type > >::type >::value && ... );
+	}
+
+public:
+	Packed() { _construct( []( auto ) { return _ValueInit{}; } ); }
+
+	explicit Packed( Implementor const & object )
+		{ _construct( [&object]( auto member ) -> decltype( auto ) { return object.*decltype( member )::kPOINTER; } ); }
+
+	explicit Packed( Implementor && object )
+		{ _construct( [&object]( auto member ) -> decltype( auto ) { return ::std::move( object.*decltype( member )::kPOINTER ); } ); }
+
+	Packed( Packed const & other )
+		{ _construct( [&other]( auto member ) -> decltype( auto ) { return other._member< decltype( member ) >(); } ); }
+
+	// Noexcept when every member moves without throwing, so that vectors of Packed move on growth.
+	Packed( Packed && other ) noexcept( _nothrow_move( Members{} ) )
+		{ _construct( [&other]( auto member ) -> decltype( auto ) { return ::std::move( other._member< decltype( member ) >() ); } ); }
+
+	Packed & operator=( Packed const & other )
+	{
+		for_each_member< Implementor >( [&]( auto, auto member ) { _assign( _member< decltype( member ) >(), other._member< decltype( member ) >() ); } );
+		return *this;
+	}
+
+	Packed & operator=( Packed && other )
+	{
+		for_each_member< Implementor >( [&]( auto, auto member ) { _assign( _member< decltype( member ) >(), ::std::move( other._member< decltype( member ) >() ) ); } );
+		return *this;
+	}
+
+	~Packed() { _destroy( L::kNB_MEMBERS ); }
+
+
+	// Const members of Implementor can only be set at its construction and are left as is.
+	void unpack( Implementor & object ) const &
+	{
+		for_each_member< Implementor >( [&]( auto, auto member )
+		{
+			using Member = decltype( member );
+			if constexpr ( ! ::std::is_const< typename Member::type >::value ) _assign( object.*Member::kPOINTER, _member< Member >() );
+		} );
+	}
+
+	void unpack( Implementor & object ) &&
+	{
+		for_each_member< Implementor >( [&]( auto, auto member )
+		{
+			using Member = decltype( member );
+			if constexpr ( ! ::std::is_const< typename Member::type >::value ) _assign( object.*Member::kPOINTER, ::std::move( _member< Member >() ) );
+		} );
+	}
+
+
+	template< typename OtherType >
+	typename member_read<OtherType>::type get( ::std::string const & name ) const { return _at< OtherType >( _rank( name ) ); }
+
+	template< typename OtherType >
+	typename member_access<OtherType>::type get( ::std::string const & name ) { return _at< OtherType >( _rank( name ) ); }
+
+	template< typename OtherType >
+	typename member_read<OtherType>::type get( unsigned rank ) const { return _at< OtherType >( rank ); }
+
+	template< typename OtherType >
+	typename member_access<OtherType>::type get( unsigned rank ) { return _at< OtherType >( rank ); }
+
+	template< unsigned GET_RANK, typename OtherType >
+	typename member_read<OtherType>::type get() const
+	{
+		static_assert( ::std::is_same< OtherType, typename member_at< GET_RANK, Members >::type::type >::value, "Bad type" );
+		return *reinterpret_cast< OtherType const * >( _storage + L::kPACKED_OFFSETS[ GET_RANK ] );
+	}
+
+	template< unsigned GET_RANK, typename OtherType >
+	typename member_access<OtherType>::type get()
+	{
+		static_assert( ::std::is_same< OtherType, typename member_at< GET_RANK, Members >::type::type >::value, "Bad type" );
+		return *reinterpret_cast< OtherType * >( _storage + L::kPACKED_OFFSETS[ GET_RANK ] );
+	}
+
+
+	static ::std::size_t nb_members() { return L::kNB_MEMBERS; }
+	static bool has_member( ::std::string const & name ) { return Implementor::has_member( name ); }
+	static char const * member_name( unsigned rank ) { return Implementor::member_name( rank ); }
+
+	::std::type_info const & member_type( unsigned rank ) const
+	{
+		::std::type_info const * result = nullptr;
+		if ( rank >= L::kNB_MEMBERS ) throw EBadRank{};
+		for_each_member< Implementor >( [&]( auto member_rank, auto member ) { if ( member_rank == rank ) result = &typeid( typename decltype( member )::type ); } );
+		return *result;
+	}
+
+	::std::type_info const & member_type( ::std::string const & name ) const { return member_type( _rank( name ) ); }
+
+private:
+	template< typename Member >
+	static constexpr unsigned _rank_of()
+	{
+		return _rank_of< Member >( Members{} );
+	}
+
+	template< typename Member, typename... AllMembers >
+	static constexpr unsigned _rank_of( MemberList< AllMembers... > )
+	{
+		constexpr bool matches[] = { ::std::is_same< Member, AllMembers >::value... };
+		unsigned rank = 0;
+		while ( false == matches[ rank ] ) ++rank;
+		return rank;
+	}
+
+	template< typename Member >
+	stored< typename Member::type > & _member()
+		{ return *reinterpret_cast< stored< typename Member::type > * >( _storage + L::kPACKED_OFFSETS[ _rank_of< Member >() ] ); }
+
+	template< typename Member >
+	stored< typename Member::type > const & _member() const
+		{ return *reinterpret_cast< stored< typename Member::type > const * >( _storage + L::kPACKED_OFFSETS[ _rank_of< Member >() ] ); }
+
+	template< typename Target, typename Source >
+	static void _assign( Target & target, Source && source )
+	{
+		if constexpr ( ::std::is_array< Target >::value )
+		{
+			for ( ::std::size_t i = 0; i < ::std::extent< Target >::value; ++i ) _assign( target[i], ::std::forward< Source >( source )[i] );
+		}
+		else
+		{
+			target = ::std::forward< Source >( source );
+		}
+	}
+
+	struct _ValueInit {};
+
+	template< typename Target, typename Source >
+	static void _create( void * address, Source && source )
+	{
+		constexpr bool kVALUE_INIT = ::std::is_same< typename ::std::decay< Source >::type, _ValueInit >::value;
+
+		if constexpr ( ::std::is_array< Target >::value )
+		{
+			using Element = typename ::std::remove_extent< Target >::type;
+			Element * const elements = static_cast< Element * >( address );
+
+			::std::size_t i = 0;
+
+			try
+			{
+				for ( ; i < ::std::extent< Target >::value; ++i )
+				{
+					if constexpr ( kVALUE_INIT ) _create< Element >( elements + i, source );
+					else _create< Element >( elements + i, ::std::forward< Source >( source )[i] );
+				}
+			}
+			catch( ... )
+			{
+				while ( i > 0 ) _destroy_at( elements + --i );
+				throw;
+			}
+		}
+		else if constexpr ( kVALUE_INIT )
+		{
+			::new ( address ) Target();
+		}
+		else
+		{
+			::new ( address ) Target( ::std::forward< Source >( source ) );
+		}
+	}
+
+	template< typename Source >
+	void _construct( Source && source )
+	{
+		::std::size_t constructed = 0;
+
+		try
+		{
+			for_each_member< Implementor >( [&]( auto rank, auto member )
+			{
+				using Target = stored< typename decltype( member )::type >;
+				_create< Target >( _storage + L::kPACKED_OFFSETS[ rank ], source( member ) );
+				++constructed;
+			} );
+		}
+		catch( ... )
+		{
+			_destroy( constructed );
+			throw;
+		}
+	}
+
+	void _destroy( ::std::size_t nb_constructed )
+	{
+		for_each_member< Implementor >( [&]( auto rank, auto member )
+		{
+			using Target = stored< typename decltype( member )::type >;
+			if ( rank < nb_constructed ) _destroy_at( reinterpret_cast< Target * >( _storage + L::kPACKED_OFFSETS[ rank ] ) );
+		} );
+	}
+
+	template< typename Target >
+	static void _destroy_at( Target * target )
+	{
+		if constexpr ( ::std::is_array< Target >::value )
+		{
+			for ( auto & element : *target ) _destroy_at( &element );
+		}
+		else
+		{
+			target->~Target();
+		}
+	}
+
+	static unsigned _rank( ::std::string const & name )
+	{
+		for ( unsigned rank = 0; rank < L::kNB_MEMBERS; ++rank )
+		{
+			if ( Implementor::member_name( rank ) == name ) return rank;
+		}
+		throw EBadName{};
+	}
+
+	template< typename OtherType >
+	static void _check( unsigned rank )
+	{
+		bool same = false;
+		if ( rank >= L::kNB_MEMBERS ) throw EBadRank{};
+		for_each_member< Implementor >( [&]( auto member_rank, auto member )
+		{
+			if ( member_rank == rank ) same = ::std::is_same< OtherType, typename decltype( member )::type >::value;
+		} );
+		if ( false == same ) throw EBadType{};
+	}
+
+	template< typename OtherType >
+	typename member_read<OtherType>::type _at( unsigned rank ) const
+	{
+		_check< OtherType >( rank );
+		return *reinterpret_cast< OtherType const * >( _storage + L::kPACKED_OFFSETS[ rank ] );
+	}
+
+	template< typename OtherType >
+	typename member_access<OtherType>::type _at( unsigned rank )
+	{
+		_check< OtherType >( rank );
+		return *reinterpret_cast< OtherType * >( _storage + L::kPACKED_OFFSETS[ rank ] );
+	}
+
+	alignas( L::kPACKED_ALIGNMENT ) unsigned char _storage[ L::kPACKED_SIZE ];
+};
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,451 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+// Files are mapped with POSIX calls, so this header is POSIX-only.
+#if defined( _WIN32 )
+#error "IntrospectMapped.hxx needs POSIX mmap"
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "apophenic/Introspect.hxx"
+#include "apophenic/IntrospectCompare.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+struct EBadFile : Error {};
+struct EBadSchema : Error {};
+
+
+
+enum class eMappedLayout : ::std::uint32_t
+{
+		ROWS
+	,	COLUMNS
+};
+
+
+
+// How a member type is laid out in a mapped file: trivially copyable types are stored
+// in place, strings as a (offset, size) reference into the side heap. Pointers are
+// rejected, they would only mean something to the process that wrote the file.
+template< typename StorageType, typename = void >
+struct mapped_traits;
+
+
+template< typename StorageType >
+struct mapped_traits< StorageType, typename ::std::enable_if< ::std::is_trivially_copyable< StorageType >::value >::type >
+{
+	static_assert(	! ::std::is_pointer< typename ::std::remove_all_extents< StorageType >::type >::value
+				&&	! ::std::is_member_pointer< typename ::std::remove_all_extents< StorageType >::type >::value
+				,	"Pointers cannot be mapped" );
+
+	using read_type = StorageType const &;
+	static constexpr ::std::size_t kSIZE = sizeof( StorageType );
+	static constexpr ::std::size_t kALIGN = alignof( StorageType );
+
+	static void store( unsigned char * field, StorageType const & value, ::std::string & )
+		{ ::std::memcpy( field, &value, sizeof( StorageType ) ); }
+
+	static read_type load( unsigned char const * field, unsigned char const *, ::std::uint64_t )
+		{ return *reinterpret_cast< StorageType const * >( field ); }
+};
+
+
+template<>
+struct mapped_traits< ::std::string >
+{
+	using read_type = ::std::string_view;
+	static constexpr ::std::size_t kSIZE = 2 * sizeof( ::std::uint64_t );
+	static constexpr ::std::size_t kALIGN = alignof( ::std::uint64_t );
+
+	static void store( unsigned char * field, ::std::string const & value, ::std::string & heap )
+	{
+		::std::uint64_t const reference[2] = { heap.size(), value.size() };
+		::std::memcpy( field, reference, sizeof( reference ) );
+		heap.append( value );
+	}
+
+	// Throws EBadFile when the reference points out of the heap.
+	static read_type load( unsigned char const * field, unsigned char const * heap, ::std::uint64_t heap_size )
+	{
+		::std::uint64_t reference[2];
+		::std::memcpy( reference, field, sizeof( reference ) );
+		if ( reference[0] > heap_size || reference[1] > heap_size - reference[0] ) throw EBadFile{};
+		return read_type( reinterpret_cast< char const * >( heap + reference[0] ), reference[1] );
+	}
+};
+
+
+template< typename StorageType >
+using mapped_type = mapped_traits< typename ::std::remove_cv< StorageType >::type >;
+
+
+template< typename StorageType >
+::std::uint64_t mapped_type_tag()
+{
+	return hash_combine( type_tag< StorageType >(), mapped_type< StorageType >::kSIZE );
+}
+
+
+
+struct _MappedHeader
+{
+	char magic[8];
+	::std::uint32_t layout;
+	::std::uint32_t nb_members;
+	::std::uint64_t nb_records;
+	::std::uint64_t heap_offset;
+	::std::uint64_t heap_size;
+};
+
+
+struct _MappedEntry
+{
+	::std::uint64_t type_tag;
+	::std::uint64_t position;
+	::std::uint64_t stride;
+	::std::uint32_t size;
+	::std::uint32_t name_length;
+};
+
+
+constexpr char kMAPPED_MAGIC[8] = { 'A', 'P', 'M', 'A', 'P', 'R', 'E', 'C' };
+
+
+inline ::std::uint64_t _align_up( ::std::uint64_t value, ::std::uint64_t alignment )
+{
+	return ( value + alignment - 1 ) / alignment * alignment;
+}
+
+
+
+// Writes [first, last) of introspected records to path, schema header first,
+// then one fixed-width section (row-major or one column per member), then the side heap.
+template< class Implementor, typename Iterator >
+void write_mapped( ::std::string const & path, Iterator first, Iterator last, eMappedLayout layout = eMappedLayout::ROWS )
+{
+	using Members = typename Implementor::Members;
+	constexpr ::std::size_t kNB_MEMBERS = Members::kSIZE;
+
+	::std::uint64_t const nb_records = ::std::distance( first, last );
+	_MappedEntry entries[ kNB_MEMBERS ];
+	char const * names[ kNB_MEMBERS ];
+
+	::std::uint64_t schema_size = sizeof( _MappedHeader );
+	::std::uint64_t row_size = 0, row_align = 1;
+
+	for_each_member< Implementor >( [&]( auto rank, auto member )
+	{
+		using Traits = mapped_type< typename decltype( member )::type >;
+		names[ rank ] = decltype( member )::kNAME;
+		entries[ rank ] = _MappedEntry{
+				mapped_type_tag< typename decltype( member )::type >()
+			,	_align_up( row_size, Traits::kALIGN )
+			,	0
+			,	static_cast< ::std::uint32_t >( Traits::kSIZE )
+			,	static_cast< ::std::uint32_t >( ::std::strlen( names[ rank ] ) )
+			};
+		row_size = entries[ rank ].position + Traits::kSIZE;
+		row_align = ::std::max< ::std::uint64_t >( row_align, Traits::kALIGN );
+		schema_size += sizeof( _MappedEntry ) + _align_up( entries[ rank ].name_length, 8 );
+	} );
+
+	row_size = _align_up( row_size, row_align );
+	::std::uint64_t const data_offset = _align_up( schema_size, 64 );
+	::std::uint64_t data_end = data_offset;
+
+	for ( ::std::size_t rank = 0; rank < kNB_MEMBERS; ++rank )
+	{
+		if ( eMappedLayout::ROWS == layout )
+		{
+			entries[ rank ].position += data_offset;
+			entries[ rank ].stride = row_size;
+			data_end = data_offset + nb_records * row_size;
+		}
+		else
+		{
+			entries[ rank ].position = _align_up( data_end, 64 );
+			entries[ rank ].stride = entries[ rank ].size;
+			data_end = entries[ rank ].position + nb_records * entries[ rank ].size;
+		}
+	}
+
+	::std::ofstream out( path, ::std::ios::binary | ::std::ios::trunc );
+	if ( ! out ) throw EBadFile{};
+
+	_MappedHeader header{
+			{}
+		,	static_cast< ::std::uint32_t >( layout )
+		,	static_cast< ::std::uint32_t >( kNB_MEMBERS )
+		,	nb_records
+		,	_align_up( data_end, 8 )
+		,	0
+		};
+	::std::memcpy( header.magic, kMAPPED_MAGIC, sizeof( kMAPPED_MAGIC ) );
+	out.write( reinterpret_cast< char const * >( &header ), sizeof( header ) );
+
+	char const padding[64] = {};
+
+	for ( ::std::size_t rank = 0; rank < kNB_MEMBERS; ++rank )
+	{
+		out.write( reinterpret_cast< char const * >( &entries[ rank ] ), sizeof( _MappedEntry ) );
+		out.write( names[ rank ], entries[ rank ].name_length );
+		out.write( padding, _align_up( entries[ rank ].name_length, 8 ) - entries[ rank ].name_length );
+	}
+
+	out.write( padding, data_offset - schema_size );
+
+	// Records are streamed out; only the side heap is held in memory.
+	::std::string heap;
+	::std::uint64_t written = data_offset;
+
+	if ( eMappedLayout::ROWS == layout )
+	{
+		::std::vector< unsigned char > row( row_size );
+
+		for ( Iterator it = first; it != last; ++it )
+		{
+			Implementor const & record = *it;
+			::std::fill( row.begin(), row.end(), 0 );
+
+			for_each_member< Implementor >( [&]( auto rank, auto member )
+			{
+				using Member = decltype( member );
+				unsigned char * const field = row.data() + entries[ rank ].position - data_offset;
+				mapped_type< typename Member::type >::store( field, record.*Member::kPOINTER, heap );
+			} );
+
+			out.write( reinterpret_cast< char const * >( row.data() ), row.size() );
+		}
+
+		written += nb_records * row_size;
+	}
+	else
+	{
+		for_each_member< Implementor >( [&]( auto rank, auto member )
+		{
+			using Member = decltype( member );
+			unsigned char field[ mapped_type< typename Member::type >::kSIZE ];
+
+			out.write( padding, entries[ rank ].position - written );
+
+			for ( Iterator it = first; it != last; ++it )
+			{
+				Implementor const & record = *it;
+				mapped_type< typename Member::type >::store( field, record.*Member::kPOINTER, heap );
+				out.write( reinterpret_cast< char const * >( field ), sizeof( field ) );
+			}
+
+			written = entries[ rank ].position + nb_records * sizeof( field );
+		} );
+	}
+
+	out.write( padding, header.heap_offset - written );
+	out.write( heap.data(), heap.size() );
+
+	header.heap_size = heap.size();
+	out.seekp( 0 );
+	out.write( reinterpret_cast< char const * >( &header ), sizeof( header ) );
+
+	if ( ! out ) throw EBadFile{};
+}
+
+
+
+// Typed view of one member across all records of a mapped file, resolved once.
+template< typename StorageType >
+class MappedColumn
+{
+public:
+	using read_type = typename mapped_type< StorageType >::read_type;
+
+	MappedColumn( unsigned char const * first, ::std::uint64_t stride, unsigned char const * heap, ::std::uint64_t heap_size )
+		: _first( first ), _stride( stride ), _heap( heap ), _heap_size( heap_size ) {}
+
+	read_type operator[]( ::std::size_t index ) const
+		{ return mapped_type< StorageType >::load( _first + index * _stride, _heap, _heap_size ); }
+
+private:
+	unsigned char const * _first;
+	::std::uint64_t _stride;
+	unsigned char const * _heap;
+	::std::uint64_t _heap_size;
+};
+
+
+
+// Read-only memory mapping of a file written by write_mapped. Opening only reads and checks
+// the schema; records are faulted in page by page when their fields are accessed.
+template< class Implementor >
+class MappedFile
+{
+	using Members = typename Implementor::Members;
+	static constexpr ::std::size_t kNB_MEMBERS = Members::kSIZE;
+
+public:
+	explicit MappedFile( ::std::string const & path )
+		: _base( nullptr ), _length( 0 )
+	{
+		int const fd = ::open( path.c_str(), O_RDONLY );
+		if ( fd < 0 ) throw EBadFile{};
+
+		struct stat status;
+		if ( 0 != ::fstat( fd, &status ) || static_cast< ::std::size_t >( status.st_size ) < sizeof( _MappedHeader ) )
+		{
+			::close( fd );
+			throw EBadFile{};
+		}
+
+		_length = status.st_size;
+		void * const mapping = ::mmap( nullptr, _length, PROT_READ, MAP_SHARED, fd, 0 );
+		::close( fd );
+		if ( MAP_FAILED == mapping ) throw EBadFile{};
+		_base = static_cast< unsigned char const * >( mapping );
+
+		try
+		{
+			_bind_schema();
+		}
+		catch( ... )
+		{
+			::munmap( const_cast< unsigned char * >( _base ), _length );
+			throw;
+		}
+	}
+
+	MappedFile( MappedFile const & ) = delete;
+	MappedFile & operator=( MappedFile const & ) = delete;
+
+	~MappedFile() { ::munmap( const_cast< unsigned char * >( _base ), _length ); }
+
+
+	::std::size_t size() const { return _header().nb_records; }
+	eMappedLayout layout() const { return static_cast< eMappedLayout >( _header().layout ); }
+
+
+	template< unsigned GET_RANK, typename OtherType >
+	typename mapped_type<OtherType>::read_type get( ::std::size_t index ) const
+	{
+		static_assert( ::std::is_same< OtherType, typename member_at< GET_RANK, Members >::type::type >::value, "Bad type" );
+		return column< OtherType >( GET_RANK )[ index ];
+	}
+
+	template< typename OtherType >
+	typename mapped_type<OtherType>::read_type get( ::std::size_t index, unsigned rank ) const
+		{ return column< OtherType >( rank )[ index ]; }
+
+	template< typename OtherType >
+	typename mapped_type<OtherType>::read_type get( ::std::size_t index, ::std::string const & name ) const
+		{ return column< OtherType >( name )[ index ]; }
+
+
+	template< typename OtherType >
+	MappedColumn< OtherType > column( unsigned rank ) const
+	{
+		if ( rank >= kNB_MEMBERS ) throw EBadRank{};
+		if ( *_types[ rank ] != typeid( OtherType ) ) throw EBadType{};
+		return MappedColumn< OtherType >( _base + _positions[ rank ], _strides[ rank ], _base + _header().heap_offset, _header().heap_size );
+	}
+
+	template< typename OtherType >
+	MappedColumn< OtherType > column( ::std::string const & name ) const
+	{
+		for ( unsigned rank = 0; rank < kNB_MEMBERS; ++rank )
+		{
+			if ( Implementor::member_name( rank ) == name ) return column< OtherType >( rank );
+		}
+		throw EBadName{};
+	}
+
+private:
+	_MappedHeader const & _header() const { return *reinterpret_cast< _MappedHeader const * >( _base ); }
+
+	void _bind_schema()
+	{
+		_MappedHeader const & header = _header();
+
+		if ( 0 != ::std::memcmp( header.magic, kMAPPED_MAGIC, sizeof( kMAPPED_MAGIC ) ) ) throw EBadFile{};
+		if ( header.heap_size > _length || header.heap_offset > _length - header.heap_size ) throw EBadFile{};
+
+		::std::vector< _MappedEntry const * > entries;
+		::std::vector< ::std::string_view > names;
+		::std::uint64_t cursor = sizeof( _MappedHeader );
+
+		for ( ::std::uint32_t i = 0; i < header.nb_members; ++i )
+		{
+			if ( cursor > _length || sizeof( _MappedEntry ) > _length - cursor ) throw EBadFile{};
+			_MappedEntry const * const entry = reinterpret_cast< _MappedEntry const * >( _base + cursor );
+			cursor += sizeof( _MappedEntry );
+			if ( entry->name_length > _length - cursor ) throw EBadFile{};
+			entries.push_back( entry );
+			names.emplace_back( reinterpret_cast< char const * >( _base + cursor ), entry->name_length );
+			cursor += _align_up( entry->name_length, 8 );
+		}
+
+		for_each_member< Implementor >( [&]( auto rank, auto member )
+		{
+			using Member = decltype( member );
+			using StorageType = typename Member::type;
+
+			for ( ::std::size_t i = 0; i < entries.size(); ++i )
+			{
+				if ( names[i] != Member::kNAME ) continue;
+
+				_MappedEntry const & entry = *entries[i];
+
+				if (	entry.type_tag != mapped_type_tag< StorageType >()
+					||	entry.size != mapped_type< StorageType >::kSIZE
+					||	(	0 != header.nb_records
+						&&	(	entry.position > header.heap_offset
+							||	entry.size > header.heap_offset - entry.position
+							||	(	0 != entry.stride
+								&&	header.nb_records - 1 > ( header.heap_offset - entry.position - entry.size ) / entry.stride
+								)
+							)
+						)
+					)
+				{
+					throw EBadSchema{};
+				}
+
+				_positions[ rank ] = entry.position;
+				_strides[ rank ] = entry.stride;
+				_types[ rank ] = &typeid( StorageType );
+				return;
+			}
+
+			throw EBadSchema{};
+		} );
+	}
+
+	unsigned char const * _base;
+	::std::size_t _length;
+	::std::uint64_t _positions[ kNB_MEMBERS ];
+	::std::uint64_t _strides[ kNB_MEMBERS ];
+	::std::type_info const * _types[ kNB_MEMBERS ];
+};
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+#include "apophenic/Introspect.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+// Compile-time member path: Path< Member< &Order::instrument >, Member< &Instrument::venue > >
+// resolves to a chain of pointer-to-member accesses, with no lookup at all.
+template< typename Member, typename... NextMembers >
+struct Path
+{
+	using Next = Path< NextMembers... >;
+	using type = typename Next::type;
+
+	template< typename Object >
+	static decltype( auto ) get( Object & object ) { return Next::get( object.*Member::kPOINTER ); }
+
+	static ::std::string name() { return ::std::string( Member::kNAME ) + "." + Next::name(); }
+};
+
+
+template< typename Member >
+struct Path< Member >
+{
+	using type = typename Member::type;
+
+	template< typename Object >
+	static decltype( auto ) get( Object & object ) { return object.*Member::kPOINTER; }
+
+	static ::std::string name() { return Member::kNAME; }
+};
+
+
+template< typename... Members, typename Object >
+decltype( auto ) get_path( Object & object ) { return Path< Members... >::get( object ); }
+
+
+
+// Finds the member of Implementor named by the first segment of path and either stops there,
+// or carries on inside that member when it is itself introspected. Introspected members are
+// stored by value, so the whole path folds into a single offset from the root.
+template< class Implementor, typename OtherType >
+bool _resolve_path( ::std::string const & path, ::std::size_t begin, ::std::size_t & offset )
+{
+	::std::size_t const dot = path.find( '.', begin );
+	::std::size_t const length = ( ::std::string::npos == dot ? path.size() : dot ) - begin;
+	bool found = false;
+
+	for_each_member< Implementor >( [&]( auto, auto member )
+	{
+		using Member = decltype( member );
+		using StorageType = typename Member::type;
+
+		if ( found || 0 != path.compare( begin, length, Member::kNAME ) ) return;
+		found = true;
+
+		::std::size_t const member_offset_in_parent = member_offset< Implementor, Member >();
+
+		if ( ::std::string::npos == dot )
+		{
+			if ( false == ::std::is_same< OtherType, StorageType >::value ) throw EBadType{};
+			offset += member_offset_in_parent;
+		}
+		else if constexpr ( is_introspected< typename ::std::remove_cv< StorageType >::type >::value )
+		{
+			offset += member_offset_in_parent;
+			if ( false == _resolve_path< typename ::std::remove_cv< StorageType >::type, OtherType >( path, dot + 1, offset ) ) throw EBadName{};
+		}
+		else
+		{
+			throw EBadName{};
+		}
+	} );
+
+	return found;
+}
+
+
+// Dotted path such as "instrument.venue.code", resolved once against Root.
+// Throws EBadName or EBadType like get<T>( name ).
+template< class Root, typename OtherType >
+class PathHandle
+{
+public:
+	using type = OtherType;
+
+	explicit PathHandle( ::std::string const & path ) : _offset( 0 )
+	{
+		if ( false == _resolve_path< Root, OtherType >( path, 0, _offset ) ) throw EBadName{};
+	}
+
+	::std::size_t offset() const { return _offset; }
+
+	typename member_read<OtherType>::type get( Root const & root ) const
+		{ return *reinterpret_cast< OtherType const * >( reinterpret_cast< char const * >( &root ) + _offset ); }
+
+	typename member_access<OtherType>::type get( Root & root ) const
+		{ return *reinterpret_cast< OtherType * >( reinterpret_cast< char * >( &root ) + _offset ); }
+
+private:
+	::std::size_t _offset;
+};
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "apophenic/Introspect.hxx"
+#include "apophenic/IntrospectThreads.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+// Query expressions are written against member names and carry no knowledge of the
+// introspected type; prepare<Implementor>() resolves every name once into a MemberHandle
+// and yields a predicate whose structure is known at compile time.
+struct _Expression {};
+
+template< typename T >
+using is_expression = ::std::is_base_of< _Expression, T >;
+
+
+
+template< typename OtherType >
+struct Field
+{
+	::std::string name;
+};
+
+
+template< typename OtherType >
+Field< OtherType > field( ::std::string name ) { return Field< OtherType >{ ::std::move( name ) }; }
+
+
+
+template< typename OtherType, typename Operator >
+struct Comparison : _Expression
+{
+	using ValueType = typename ::std::remove_cv< OtherType >::type;
+
+	::std::string name;
+	ValueType value;
+
+	template< class Implementor >
+	struct Bound
+	{
+		MemberHandle< Implementor, OtherType > handle;
+		ValueType value;
+
+		bool operator()( Implementor const & object ) const { return Operator()( handle.get( object ), value ); }
+	};
+
+	template< class Implementor >
+	Bound< Implementor > bind() const { return Bound< Implementor >{ MemberHandle< Implementor, OtherType >( name ), value }; }
+};
+
+
+template< typename Left, typename Right >
+struct And : _Expression
+{
+	Left left;
+	Right right;
+
+	template< class Implementor >
+	auto bind() const
+	{
+		auto bound_left = left.template bind< Implementor >();
+		auto bound_right = right.template bind< Implementor >();
+		return [bound_left, bound_right]( Implementor const & object ) { return bound_left( object ) && bound_right( object ); };
+	}
+};
+
+
+template< typename Left, typename Right >
+struct Or : _Expression
+{
+	Left left;
+	Right right;
+
+	template< class Implementor >
+	auto bind() const
+	{
+		auto bound_left = left.template bind< Implementor >();
+		auto bound_right = right.template bind< Implementor >();
+		return [bound_left, bound_right]( Implementor const & object ) { return bound_left( object ) || bound_right( object ); };
+	}
+};
+
+
+template< typename Operand >
+struct Not : _Expression
+{
+	Operand operand;
+
+	template< class Implementor >
+	auto bind() const
+	{
+		auto bound = operand.template bind< Implementor >();
+		return [bound]( Implementor const & object ) { return ! bound( object ); };
+	}
+};
+
+
+
+#define AP_INSP_COMPARISON( _op, _functor ) \
+	template< typename OtherType, typename Value > \
+	Comparison< OtherType, _functor<> > operator _op( Field< OtherType > const & f, Value && value ) \
+		{ return { {}, f.name, ::std::forward< Value >( value ) }; }
+
+AP_INSP_COMPARISON( ==, ::std::equal_to )
+AP_INSP_COMPARISON( !=, ::std::not_equal_to )
+AP_INSP_COMPARISON( <, ::std::less )
+AP_INSP_COMPARISON( <=, ::std::less_equal )
+AP_INSP_COMPARISON( >, ::std::greater )
+AP_INSP_COMPARISON( >=, ::std::greater_equal )
+
+#undef AP_INSP_COMPARISON
+
+
+template<
+		typename Left
+	,	typename Right
+	,	typename ::std::enable_if< is_expression<Left>::value && is_expression<Right>::value, int >::type = 0
+	>
+And< Left, Right > operator&&( Left const & left, Right const & right ) { return { {}, left, right }; }
+
+template<
+		typename Left
+	,	typename Right
+	,	typename ::std::enable_if< is_expression<Left>::value && is_expression<Right>::value, int >::type = 0
+	>
+Or< Left, Right > operator||( Left const & left, Right const & right ) { return { {}, left, right }; }
+
+template<
+		typename Operand
+	,	typename ::std::enable_if< is_expression<Operand>::value, int >::type = 0
+	>
+Not< Operand > operator!( Operand const & operand ) { return { {}, operand }; }
+
+
+
+template< class Implementor, typename Predicate >
+class PreparedQuery
+{
+public:
+	explicit PreparedQuery( Predicate predicate ) : _predicate( ::std::move( predicate ) ) {}
+
+	bool matches( Implementor const & object ) const { return _predicate( object ); }
+
+	// Indices of matching objects, in container order. Container needs random access.
+	// Threads is a number of threads, started and joined by each call, or a ThreadPool
+	// kept by callers querying again and again.
+	template< typename Container, typename Threads = unsigned >
+	::std::vector< ::std::size_t > indices( Container const & objects, Threads && threads = 1 ) const
+	{
+		return _collect< ::std::size_t >( objects, threads, []( Implementor const &, ::std::size_t index ) { return index; } );
+	}
+
+	template< typename Container >
+	::std::size_t count( Container const & objects ) const
+	{
+		::std::size_t result = 0;
+		for ( Implementor const & object : objects ) result += _predicate( object ) ? 1 : 0;
+		return result;
+	}
+
+	// Projection of one member of matching objects, in container order.
+	template< typename OtherType, typename Container, typename Threads = unsigned >
+	auto select( ::std::string const & name, Container const & objects, Threads && threads = 1 ) const
+	{
+		using ValueType = typename ::std::decay< typename member_read< OtherType >::type >::type;
+		MemberHandle< Implementor, OtherType > const handle( name );
+
+		return _collect< ValueType >( objects, threads, [&handle]( Implementor const & object, ::std::size_t )
+		{
+			return ValueType( handle.get( object ) );
+		} );
+	}
+
+private:
+	template< typename Value, typename Container, typename Projection >
+	::std::vector< Value > _collect( Container const & objects, unsigned nb_threads, Projection const & projection ) const
+	{
+		::std::size_t const size = ::std::distance( ::std::begin( objects ), ::std::end( objects ) );
+		ThreadPool pool( ::std::min< ::std::size_t >( ::std::max( 1u, nb_threads ), ::std::max< ::std::size_t >( 1, size ) ) );
+		return _collect< Value >( objects, pool, projection );
+	}
+
+	template< typename Value, typename Container, typename Projection >
+	::std::vector< Value > _collect( Container const & objects, ThreadPool & pool, Projection const & projection ) const
+	{
+		auto const first = ::std::begin( objects );
+		::std::size_t const size = ::std::distance( first, ::std::end( objects ) );
+		::std::vector< ::std::vector< Value > > partials( pool.size() );
+
+		pool.run_chunks( size, [&]( ::std::size_t begin, ::std::size_t end, unsigned chunk )
+		{
+			::std::vector< Value > & partial = partials[ chunk ];
+			for ( ::std::size_t index = begin; index < end; ++index )
+			{
+				Implementor const & object = first[ index ];
+				if ( _predicate( object ) ) partial.push_back( projection( object, index ) );
+			}
+		} );
+
+		::std::vector< Value > result = ::std::move( partials.front() );
+		for ( ::std::size_t chunk = 1; chunk < partials.size(); ++chunk )
+		{
+			::std::move( partials[ chunk ].begin(), partials[ chunk ].end(), ::std::back_inserter( result ) );
+		}
+		return result;
+	}
+
+	Predicate _predicate;
+};
+
+
+// Resolves member names and types of expression against Implementor, once.
+// Throws EBadName or EBadType like get<T>( name ).
+template< class Implementor, typename Expression >
+auto prepare( Expression const & expression )
+{
+	static_assert( is_expression< Expression >::value, "Not a query expression" );
+	auto predicate = expression.template bind< Implementor >();
+	return PreparedQuery< Implementor, decltype( predicate ) >( ::std::move( predicate ) );
+}
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "apophenic/Introspect.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+// Relaxed atomic copies of trivially copyable values, one aligned word at a time.
+template< typename StorageType >
+struct _seqlock_word
+{
+	using type = typename ::std::conditional< 0 == alignof( StorageType ) % 8 && 0 == sizeof( StorageType ) % 8, ::std::uint64_t,
+		typename ::std::conditional< 0 == alignof( StorageType ) % 4 && 0 == sizeof( StorageType ) % 4, ::std::uint32_t,
+		typename ::std::conditional< 0 == alignof( StorageType ) % 2 && 0 == sizeof( StorageType ) % 2, ::std::uint16_t,
+		::std::uint8_t >::type >::type >::type;
+};
+
+
+template< typename StorageType >
+void _seqlock_load( StorageType & target, StorageType const & source )
+{
+	using Word = typename _seqlock_word< StorageType >::type;
+	unsigned char * const to = reinterpret_cast< unsigned char * >( &target );
+	unsigned char const * const from = reinterpret_cast< unsigned char const * >( &source );
+
+	for ( ::std::size_t i = 0; i < sizeof( StorageType ); i += sizeof( Word ) )
+	{
+#if defined( __GNUC__ )
+		Word const word = __atomic_load_n( reinterpret_cast< Word const * >( from + i ), __ATOMIC_RELAXED );
+#else
+		Word const word = *reinterpret_cast< Word const volatile * >( from + i );
+#endif
+		::std::memcpy( to + i, &word, sizeof( Word ) );
+	}
+}
+
+
+template< typename StorageType >
+void _seqlock_store( StorageType & target, StorageType const & source )
+{
+	using Word = typename _seqlock_word< StorageType >::type;
+	unsigned char * const to = reinterpret_cast< unsigned char * >( &target );
+	unsigned char const * const from = reinterpret_cast< unsigned char const * >( &source );
+
+	for ( ::std::size_t i = 0; i < sizeof( StorageType ); i += sizeof( Word ) )
+	{
+		Word word;
+		::std::memcpy( &word, from + i, sizeof( Word ) );
+#if defined( __GNUC__ )
+		__atomic_store_n( reinterpret_cast< Word * >( to + i ), word, __ATOMIC_RELAXED );
+#else
+		*reinterpret_cast< Word volatile * >( to + i ) = word;
+#endif
+	}
+}
+
+
+
+// Results readers may return: trivially copyable values, or tuples of them.
+template< typename Result >
+struct _is_seqlock_copy : ::std::is_trivially_copyable< Result > {};
+
+template< typename... Results >
+struct _is_seqlock_copy< ::std::tuple< Results... > > : ::std::conjunction< ::std::is_trivially_copyable< Results >... > {};
+
+
+
+// Introspected object shared between writers and many readers. Writers make the version
+// odd while they update the object; readers run their copy without any lock, then retry if
+// the version moved meanwhile, so they never block the writer nor each other.
+// Writers modify a private copy, then publish its trivially copyable members word by word
+// with relaxed atomic stores, which readers copy with relaxed atomic loads: a torn copy is
+// thrown away by the retry, and no access races. Readers only see those members.
+template< class Implementor >
+class Seqlocked
+{
+public:
+	template< typename... Args >
+	explicit Seqlocked( Args &&... args ) : _version( 0 ), _object( ::std::forward< Args >( args )... ), _published( _object ) {}
+
+	Seqlocked( Seqlocked const & ) = delete;
+	Seqlocked & operator=( Seqlocked const & ) = delete;
+
+
+	// Runs modifier( Implementor & ) as one update. Writers are serialized.
+	template< typename Modifier >
+	void write( Modifier && modifier )
+	{
+		::std::uint64_t version = _version.load( ::std::memory_order_relaxed );
+
+		while ( ( version & 1 ) || false == _version.compare_exchange_weak( version, version + 1, ::std::memory_order_acquire, ::std::memory_order_relaxed ) )
+		{
+			::std::this_thread::yield();
+			version = _version.load( ::std::memory_order_relaxed );
+		}
+
+		::std::atomic_thread_fence( ::std::memory_order_release );
+
+		try
+		{
+			modifier( _object );
+		}
+		catch ( ... )
+		{
+			_publish();
+			_version.store( version + 2, ::std::memory_order_release );
+			throw;
+		}
+
+		_publish();
+		_version.store( version + 2, ::std::memory_order_release );
+	}
+
+	template< typename OtherType, typename Key >
+	void set( Key const & key, OtherType const & value )
+	{
+		write( [&]( Implementor & object ) { object.template get< OtherType >( key ) = value; } );
+	}
+
+
+	// Copy of a published member, for readers: load( object.member ).
+	template< typename StorageType >
+	static StorageType load( StorageType const & member )
+	{
+		static_assert( ::std::is_trivially_copyable< StorageType >::value, "Seqlocked readers only copy trivially copyable members" );
+		StorageType copy;
+		_seqlock_load( copy, member );
+		return copy;
+	}
+
+	// Runs reader( Implementor const & ) until it sees no concurrent write and returns its
+	// result. Reader copies the members it needs with load(), and returns copies.
+	template< typename Reader >
+	auto read( Reader && reader ) const
+	{
+		using Result = decltype( reader( _published ) );
+		static_assert( _is_seqlock_copy< Result >::value, "Seqlocked readers must return copies of trivially copyable members" );
+
+		for ( ;; )
+		{
+			::std::uint64_t const version = _version.load( ::std::memory_order_acquire );
+
+			if ( 0 == ( version & 1 ) )
+			{
+				Result const result = reader( _published );
+				::std::atomic_thread_fence( ::std::memory_order_acquire );
+				if ( version == _version.load( ::std::memory_order_relaxed ) ) return result;
+			}
+
+			::std::this_thread::yield();
+		}
+	}
+
+	// Copies of one member, by name or rank, as with get<T>( key ).
+	template< typename OtherType, typename Key >
+	OtherType get( Key const & key ) const
+	{
+		return get( MemberHandle< Implementor, OtherType >( key ) );
+	}
+
+	template< unsigned GET_RANK, typename OtherType >
+	OtherType get() const
+	{
+		using Member = typename member_at< GET_RANK, typename Implementor::Members >::type;
+		static_assert( ::std::is_same< OtherType, typename Member::type >::value, "Bad type" );
+		return read( []( Implementor const & object ) { return load( object.*Member::kPOINTER ); } );
+	}
+
+	// Consistent copies of several members resolved beforehand.
+	template< typename... OtherTypes >
+	::std::tuple< OtherTypes... > get( MemberHandle< Implementor, OtherTypes > const &... handles ) const
+	{
+		return read( [&]( Implementor const & object ) { return ::std::tuple< OtherTypes... >( load( _at( object, handles ) )... ); } );
+	}
+
+	template< typename OtherType >
+	OtherType get( MemberHandle< Implementor, OtherType > const & handle ) const
+	{
+		return read( [&]( Implementor const & object ) { return load( _at( object, handle ) ); } );
+	}
+
+
+	::std::uint64_t version() const { return _version.load( ::std::memory_order_acquire ); }
+
+	// For writers only, or once all threads are done.
+	Implementor const & unsafe_object() const { return _object; }
+
+private:
+	template< typename OtherType >
+	static OtherType const & _at( Implementor const & object, MemberHandle< Implementor, OtherType > const & handle )
+	{
+		return *reinterpret_cast< OtherType const * >( reinterpret_cast< char const * >( &object ) + handle.offset() );
+	}
+
+	void _publish()
+	{
+		for_each_member< Implementor >( [this]( auto, auto member )
+		{
+			using Member = decltype( member );
+
+			if constexpr ( ::std::is_trivially_copyable< typename Member::type >::value && ! ::std::is_const< typename Member::type >::value )
+			{
+				_seqlock_store( _published.*Member::kPOINTER, _object.*Member::kPOINTER );
+			}
+		} );
+	}
+
+	::std::atomic< ::std::uint64_t > _version;
+	Implementor _object;
+	Implementor _published;
+};
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,395 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "apophenic/Introspect.hxx"
+#include "apophenic/IntrospectCompare.hxx"
+#include "apophenic/IntrospectThreads.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+enum class eSortOrder
+{
+	ASCENDING
+,	DESCENDING
+};
+
+
+
+// Order-preserving unsigned image of scalar keys, for radix sorting.
+template< typename StorageType, typename = void >
+struct radix_traits
+{
+	static constexpr bool kENABLED = false;
+};
+
+
+template< typename StorageType >
+struct radix_traits< StorageType, typename ::std::enable_if< ::std::is_integral< StorageType >::value || ::std::is_enum< StorageType >::value >::type >
+{
+	static constexpr bool kENABLED = true;
+	static constexpr unsigned kBYTES = sizeof( StorageType );
+
+	static ::std::uint64_t key( StorageType value )
+	{
+		using Integral = typename ::std::conditional< ::std::is_enum< StorageType >::value, ::std::underlying_type< StorageType >, ::std::common_type< StorageType > >::type::type;
+		using Unsigned = typename ::std::make_unsigned< typename ::std::conditional< ::std::is_same< Integral, bool >::value, unsigned char, Integral >::type >::type;
+
+		Unsigned bits = static_cast< Unsigned >( value );
+		if ( ::std::is_signed< Integral >::value ) bits ^= Unsigned( 1 ) << ( kBYTES * 8 - 1 );
+		return bits;
+	}
+};
+
+
+template< typename StorageType >
+struct radix_traits< StorageType, typename ::std::enable_if< ::std::is_floating_point< StorageType >::value && ( 4 == sizeof( StorageType ) || 8 == sizeof( StorageType ) ) >::type >
+{
+	static constexpr bool kENABLED = true;
+	static constexpr unsigned kBYTES = sizeof( StorageType );
+
+	static ::std::uint64_t key( StorageType value )
+	{
+		using Bits = typename ::std::conditional< 4 == kBYTES, ::std::uint32_t, ::std::uint64_t >::type;
+		constexpr Bits kSIGN = Bits( 1 ) << ( kBYTES * 8 - 1 );
+
+		Bits bits;
+		::std::memcpy( &bits, &value, kBYTES );
+		return ( bits & kSIGN ) ? Bits( ~bits ) : Bits( bits | kSIGN );
+	}
+};
+
+
+
+template< typename StorageType, typename = void >
+struct _is_orderable : ::std::false_type {};
+
+template< typename StorageType >
+struct _is_orderable< StorageType, decltype( static_cast< void >( ::std::declval< StorageType const & >() < ::std::declval< StorageType const & >() ) ) > : ::std::true_type {};
+
+
+template< typename StorageType >
+int _compare_key( StorageType const & a, StorageType const & b )
+{
+	if constexpr ( is_introspected< typename ::std::remove_cv< StorageType >::type >::value )
+	{
+		return Compare< typename ::std::remove_cv< StorageType >::type >::compare( a, b );
+	}
+	else
+	{
+		return compare_value< StorageType >( a, b );
+	}
+}
+
+
+template< typename StorageType >
+using is_sortable = ::std::integral_constant< bool,
+		_is_orderable< typename ::std::remove_all_extents< StorageType >::type >::value
+	||	is_introspected< typename ::std::remove_cv< StorageType >::type >::value
+	>;
+
+
+
+// LSD radix sort of indices on 8-bit digits. Each chunk counts and scatters its own slice,
+// which keeps every pass stable; digits shared by all keys are skipped.
+template< unsigned BYTES >
+void _radix_sort( ::std::vector< ::std::uint64_t > & keys, ::std::vector< ::std::size_t > & indices, ThreadPool & pool )
+{
+	::std::size_t const size = keys.size();
+	::std::vector< ::std::uint64_t > other_keys( size );
+	::std::vector< ::std::size_t > other_indices( size );
+	::std::vector< ::std::size_t > counts( pool.size() * 256 );
+
+	for ( unsigned shift = 0; shift < BYTES * 8; shift += 8 )
+	{
+		::std::fill( counts.begin(), counts.end(), 0 );
+
+		pool.run_chunks( size, [&]( ::std::size_t begin, ::std::size_t end, unsigned chunk )
+		{
+			::std::size_t * const count = &counts[ chunk * 256 ];
+			for ( ::std::size_t i = begin; i < end; ++i ) ++count[ ( keys[i] >> shift ) & 0xff ];
+		} );
+
+		::std::size_t offset = 0;
+		bool skip = false;
+
+		for ( unsigned digit = 0; digit < 256; ++digit )
+		{
+			::std::size_t total = 0;
+			for ( unsigned chunk = 0; chunk < pool.size(); ++chunk ) total += counts[ chunk * 256 + digit ];
+			skip = skip || size == total;
+
+			for ( unsigned chunk = 0; chunk < pool.size(); ++chunk )
+			{
+				::std::size_t const count = counts[ chunk * 256 + digit ];
+				counts[ chunk * 256 + digit ] = offset;
+				offset += count;
+			}
+		}
+
+		if ( skip ) continue;
+
+		pool.run_chunks( size, [&]( ::std::size_t begin, ::std::size_t end, unsigned chunk )
+		{
+			::std::size_t * const position = &counts[ chunk * 256 ];
+			for ( ::std::size_t i = begin; i < end; ++i )
+			{
+				::std::size_t const target = position[ ( keys[i] >> shift ) & 0xff ]++;
+				other_keys[ target ] = keys[i];
+				other_indices[ target ] = indices[i];
+			}
+		} );
+
+		keys.swap( other_keys );
+		indices.swap( other_indices );
+	}
+}
+
+
+// Sorts chunks in parallel, then merges them pairwise, pairs of one level in parallel.
+template< bool STABLE, typename Less >
+void _merge_sort( ::std::vector< ::std::size_t > & indices, Less const & less, ThreadPool & pool )
+{
+	::std::size_t const size = indices.size();
+	::std::size_t const run = ::std::max< ::std::size_t >( 1, ( size + pool.size() - 1 ) / pool.size() );
+
+	pool.run_chunks( size, [&]( ::std::size_t begin, ::std::size_t end, unsigned )
+	{
+		if ( STABLE ) ::std::stable_sort( indices.begin() + begin, indices.begin() + end, less );
+		else ::std::sort( indices.begin() + begin, indices.begin() + end, less );
+	} );
+
+	::std::vector< ::std::size_t > other( size );
+
+	for ( ::std::size_t width = run; width < size; width *= 2 )
+	{
+		::std::size_t const nb_pairs = ( size + 2 * width - 1 ) / ( 2 * width );
+
+		pool.run_chunks( nb_pairs, [&]( ::std::size_t first_pair, ::std::size_t last_pair, unsigned )
+		{
+			for ( ::std::size_t pair = first_pair; pair < last_pair; ++pair )
+			{
+				::std::size_t const begin = pair * 2 * width;
+				::std::size_t const middle = ::std::min( size, begin + width );
+				::std::size_t const end = ::std::min( size, begin + 2 * width );
+				::std::merge( indices.begin() + begin, indices.begin() + middle, indices.begin() + middle, indices.begin() + end, other.begin() + begin, less );
+			}
+		} );
+
+		indices.swap( other );
+	}
+}
+
+
+// Runs function( member ) for the member of Implementor named name. Throws EBadName.
+template< class Implementor, typename Function >
+void _with_member( ::std::string const & name, Function && function )
+{
+	bool found = false;
+
+	for_each_member< Implementor >( [&]( auto, auto member )
+	{
+		if ( found || name != decltype( member )::kNAME ) return;
+		found = true;
+		function( member );
+	} );
+
+	if ( false == found ) throw EBadName{};
+}
+
+
+// Objects per chunk below which spreading a sort over more threads does not pay.
+constexpr ::std::size_t kSORT_CHUNK = 4096;
+
+
+template< class Implementor, bool STABLE, typename Container >
+::std::vector< ::std::size_t > _sort_indices( Container const & objects, ::std::string const & name, eSortOrder order, ThreadPool & shared_pool )
+{
+	auto const first = ::std::begin( objects );
+	::std::size_t const size = ::std::distance( first, ::std::end( objects ) );
+	::std::vector< ::std::size_t > indices( size );
+	ThreadPool serial( 1 );
+	ThreadPool & pool = size < 2 * kSORT_CHUNK ? serial : shared_pool;
+
+	for ( ::std::size_t i = 0; i < size; ++i ) indices[i] = i;
+
+	_with_member< Implementor >( name, [&]( auto member )
+	{
+		using Member = decltype( member );
+		using StorageType = typename Member::type;
+		using Traits = radix_traits< typename ::std::remove_cv< StorageType >::type >;
+
+		if constexpr ( Traits::kENABLED )
+		{
+			::std::uint64_t const flip = eSortOrder::DESCENDING == order ? ~::std::uint64_t( 0 ) : 0;
+			::std::vector< ::std::uint64_t > keys( size );
+
+			pool.run_chunks( size, [&]( ::std::size_t begin, ::std::size_t end, unsigned )
+			{
+				for ( ::std::size_t i = begin; i < end; ++i ) keys[i] = Traits::key( first[i].*Member::kPOINTER ) ^ flip;
+			} );
+
+			_radix_sort< Traits::kBYTES >( keys, indices, pool );
+		}
+		else if constexpr ( is_sortable< StorageType >::value )
+		{
+			int const sign = eSortOrder::DESCENDING == order ? -1 : 1;
+
+			_merge_sort< STABLE >( indices, [&]( ::std::size_t a, ::std::size_t b )
+			{
+				return sign * _compare_key< StorageType >( first[a].*Member::kPOINTER, first[b].*Member::kPOINTER ) < 0;
+			}, pool );
+		}
+		else
+		{
+			throw EBadType{};
+		}
+	} );
+
+	return indices;
+}
+
+
+
+template< class Implementor, bool STABLE, typename Container >
+::std::vector< ::std::size_t > _sort_indices( Container const & objects, ::std::string const & name, eSortOrder order, unsigned nb_threads )
+{
+	::std::size_t const size = ::std::distance( ::std::begin( objects ), ::std::end( objects ) );
+	ThreadPool pool( ::std::min< ::std::size_t >( ::std::max( 1u, nb_threads ), ::std::max< ::std::size_t >( 1, size / kSORT_CHUNK ) ) );
+	return _sort_indices< Implementor, STABLE >( objects, name, order, pool );
+}
+
+
+
+// Permutation sorting objects on the member named name: objects[ result[0] ] comes first.
+// Container needs random access. Throws EBadName, or EBadType if the member has no ordering.
+// With nb_threads, the threads are started and joined by each call; callers sorting again
+// and again pass their own pool instead.
+template< class Implementor, typename Container >
+::std::vector< ::std::size_t > sort_indices( Container const & objects, ::std::string const & name, eSortOrder order = eSortOrder::ASCENDING, unsigned nb_threads = 1 )
+{
+	return _sort_indices< Implementor, false >( objects, name, order, nb_threads );
+}
+
+template< class Implementor, typename Container >
+::std::vector< ::std::size_t > sort_indices( Container const & objects, ::std::string const & name, eSortOrder order, ThreadPool & pool )
+{
+	return _sort_indices< Implementor, false >( objects, name, order, pool );
+}
+
+
+// Same, keeping equal objects in container order.
+template< class Implementor, typename Container >
+::std::vector< ::std::size_t > stable_sort_indices( Container const & objects, ::std::string const & name, eSortOrder order = eSortOrder::ASCENDING, unsigned nb_threads = 1 )
+{
+	return _sort_indices< Implementor, true >( objects, name, order, nb_threads );
+}
+
+template< class Implementor, typename Container >
+::std::vector< ::std::size_t > stable_sort_indices( Container const & objects, ::std::string const & name, eSortOrder order, ThreadPool & pool )
+{
+	return _sort_indices< Implementor, true >( objects, name, order, pool );
+}
+
+
+// Moves objects so that objects[i] becomes the former objects[ indices[i] ], cycle by cycle.
+template< typename Container >
+void apply_permutation( Container & objects, ::std::vector< ::std::size_t > const & indices )
+{
+	auto const first = ::std::begin( objects );
+	::std::vector< bool > done( indices.size(), false );
+
+	for ( ::std::size_t start = 0; start < indices.size(); ++start )
+	{
+		if ( done[ start ] ) continue;
+
+		auto value = ::std::move( first[ start ] );
+		::std::size_t i = start;
+
+		for ( ; indices[i] != start; i = indices[i] )
+		{
+			first[i] = ::std::move( first[ indices[i] ] );
+			done[i] = true;
+		}
+
+		first[i] = ::std::move( value );
+		done[i] = true;
+	}
+}
+
+
+// Sorts objects in place. Threads is a number of threads or a ThreadPool, as with sort_indices.
+template< class Implementor, typename Container, typename Threads = unsigned >
+void sort( Container & objects, ::std::string const & name, eSortOrder order = eSortOrder::ASCENDING, Threads && threads = 1 )
+{
+	apply_permutation( objects, sort_indices< Implementor >( objects, name, order, threads ) );
+}
+
+
+template< class Implementor, typename Container, typename Threads = unsigned >
+void stable_sort( Container & objects, ::std::string const & name, eSortOrder order = eSortOrder::ASCENDING, Threads && threads = 1 )
+{
+	apply_permutation( objects, stable_sort_indices< Implementor >( objects, name, order, threads ) );
+}
+
+
+
+// Objects grouped on equal values of one member, groups in ascending key order and objects
+// in container order within a group: group g is indices[ bounds[g] ] to indices[ bounds[g+1] - 1 ].
+struct Grouping
+{
+	::std::vector< ::std::size_t > indices;
+	::std::vector< ::std::size_t > bounds;
+
+	::std::size_t nb_groups() const { return bounds.empty() ? 0 : bounds.size() - 1; }
+};
+
+
+template< class Implementor, typename Container, typename Threads = unsigned >
+Grouping group_by( Container const & objects, ::std::string const & name, Threads && threads = 1 )
+{
+	auto const first = ::std::begin( objects );
+	Grouping grouping{ stable_sort_indices< Implementor >( objects, name, eSortOrder::ASCENDING, threads ), {} };
+
+	_with_member< Implementor >( name, [&]( auto member )
+	{
+		using Member = decltype( member );
+
+		if constexpr ( is_sortable< typename Member::type >::value )
+		{
+			for ( ::std::size_t i = 0; i < grouping.indices.size(); ++i )
+			{
+				if ( 0 == i || 0 != _compare_key< typename Member::type >(
+						first[ grouping.indices[ i - 1 ] ].*Member::kPOINTER
+					,	first[ grouping.indices[i] ].*Member::kPOINTER ) )
+				{
+					grouping.bounds.push_back( i );
+				}
+			}
+		}
+
+		grouping.bounds.push_back( grouping.indices.size() );
+	} );
+
+	return grouping;
+}
+
+
+
+} // namespace insp
+} // namespace ap
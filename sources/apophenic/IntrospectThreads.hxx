@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+// Fixed set of worker threads for passes that run many short parallel steps in a row, where
+// spawning threads on every step would dominate. The calling thread takes chunk 0.
+class ThreadPool
+{
+public:
+	explicit ThreadPool( unsigned nb_threads ) : _generation( 0 ), _pending( 0 ), _stop( false )
+	{
+		for ( unsigned chunk = 1; chunk < ::std::max( 1u, nb_threads ); ++chunk )
+		{
+			_workers.emplace_back( [this, chunk] { _work( chunk ); } );
+		}
+	}
+
+	ThreadPool( ThreadPool const & ) = delete;
+	ThreadPool & operator=( ThreadPool const & ) = delete;
+
+	~ThreadPool()
+	{
+		{
+			::std::lock_guard< ::std::mutex > lock( _mutex );
+			_stop = true;
+		}
+		_wake.notify_all();
+		for ( ::std::thread & worker : _workers ) worker.join();
+	}
+
+	unsigned size() const { return _workers.size() + 1; }
+
+	// Splits [0, size) in size() contiguous chunks and runs task( begin, end, chunk ) on each.
+	template< typename Task >
+	void run_chunks( ::std::size_t size, Task && task )
+	{
+		::std::size_t const chunk_size = ( size + this->size() - 1 ) / this->size();
+
+		auto const job = [&task, size, chunk_size]( unsigned chunk )
+		{
+			::std::size_t const begin = ::std::min( size, chunk * chunk_size );
+			task( begin, ::std::min( size, begin + chunk_size ), chunk );
+		};
+
+		if ( _workers.empty() ) return job( 0 );
+
+		{
+			::std::lock_guard< ::std::mutex > lock( _mutex );
+			_job = job;
+			_pending = _workers.size();
+			++_generation;
+		}
+		_wake.notify_all();
+
+		job( 0 );
+
+		::std::unique_lock< ::std::mutex > lock( _mutex );
+		_done.wait( lock, [this] { return 0 == _pending; } );
+	}
+
+private:
+	void _work( unsigned chunk )
+	{
+		unsigned long generation = 0;
+
+		for ( ;; )
+		{
+			::std::function< void( unsigned ) > job;
+			{
+				::std::unique_lock< ::std::mutex > lock( _mutex );
+				_wake.wait( lock, [&] { return _stop || generation != _generation; } );
+				if ( _stop ) return;
+				generation = _generation;
+				job = _job;
+			}
+
+			job( chunk );
+
+			::std::lock_guard< ::std::mutex > lock( _mutex );
+			if ( 0 == --_pending ) _done.notify_one();
+		}
+	}
+
+	::std::vector< ::std::thread > _workers;
+	::std::mutex _mutex;
+	::std::condition_variable _wake;
+	::std::condition_variable _done;
+	::std::function< void( unsigned ) > _job;
+	unsigned long _generation;
+	::std::size_t _pending;
+	bool _stop;
+};
+
+
+
+} // namespace insp
+} // namespace ap
@@ -0,0 +1,325 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "apophenic/Introspect.hxx"
+#include "apophenic/IntrospectCompare.hxx"
+
+
+namespace ap
+{
+namespace insp
+{
+
+
+
+struct EUnknownSchema : Error {};
+struct ETruncated : Error {};
+
+
+
+// Wire codec of a member type. Fixed-size types are copied as raw (host order) bytes,
+// strings are length-prefixed. kWIRE_SIZE of 0 means length-prefixed, which lets readers
+// skip fields whose type they do not know.
+template< typename StorageType, typename = void >
+struct versioned_traits;
+
+
+template< typename StorageType >
+struct versioned_traits< StorageType, typename ::std::enable_if< ::std::is_trivially_copyable< StorageType >::value >::type >
+{
+	static constexpr ::std::uint32_t kWIRE_SIZE = sizeof( StorageType );
+
+	static void encode( StorageType const & value, ::std::string & out )
+		{ out.append( reinterpret_cast< char const * >( &value ), sizeof( StorageType ) ); }
+
+	static unsigned char const * decode( unsigned char const * cursor, unsigned char const * end, StorageType & value )
+	{
+		if ( end - cursor < static_cast< ::std::ptrdiff_t >( sizeof( StorageType ) ) ) throw ETruncated{};
+		::std::memcpy( &value, cursor, sizeof( StorageType ) );
+		return cursor + sizeof( StorageType );
+	}
+};
+
+
+template<>
+struct versioned_traits< ::std::string >
+{
+	static constexpr ::std::uint32_t kWIRE_SIZE = 0;
+
+	static void encode( ::std::string const & value, ::std::string & out )
+	{
+		::std::uint32_t const length = value.size();
+		out.append( reinterpret_cast< char const * >( &length ), sizeof( length ) );
+		out.append( value );
+	}
+
+	static unsigned char const * decode( unsigned char const * cursor, unsigned char const * end, ::std::string & value )
+	{
+		::std::uint32_t length;
+		cursor = versioned_traits< ::std::uint32_t >::decode( cursor, end, length );
+		if ( end - cursor < static_cast< ::std::ptrdiff_t >( length ) ) throw ETruncated{};
+		value.assign( reinterpret_cast< char const * >( cursor ), length );
+		return cursor + length;
+	}
+};
+
+
+
+struct SchemaField
+{
+	::std::string name;
+	::std::uint64_t type_tag;
+	::std::uint32_t wire_size;
+};
+
+
+struct Schema
+{
+	::std::uint64_t fingerprint;
+	::std::vector< SchemaField > fields;
+};
+
+
+inline ::std::uint64_t schema_fingerprint( ::std::vector< SchemaField > const & fields )
+{
+	::std::uint64_t state = fields.size();
+
+	for ( SchemaField const & field : fields )
+	{
+		state = hash_combine( state, hash_bytes( field.name.data(), field.name.size(), field.type_tag ) );
+		state = hash_combine( state, field.wire_size );
+	}
+
+	return state;
+}
+
+
+template< class Implementor >
+Schema const & versioned_schema()
+{
+	static Schema const schema = []
+	{
+		::std::vector< SchemaField > fields;
+
+		for_each_member< Implementor >( [&]( auto, auto member )
+		{
+			using StorageType = typename decltype( member )::type;
+			fields.push_back( SchemaField{ decltype( member )::kNAME, type_tag< StorageType >(), versioned_traits< StorageType >::kWIRE_SIZE } );
+		} );
+
+		::std::uint64_t const fingerprint = schema_fingerprint( fields );
+		return Schema{ fingerprint, ::std::move( fields ) };
+	}();
+
+	return schema;
+}
+
+
+// Schemas can be shipped alongside data (file headers, handshakes) so that readers learn
+// about writer versions they were not compiled with.
+inline void encode_schema( Schema const & schema, ::std::string & out )
+{
+	versioned_traits< ::std::uint32_t >::encode( schema.fields.size(), out );
+
+	for ( SchemaField const & field : schema.fields )
+	{
+		versioned_traits< ::std::string >::encode( field.name, out );
+		versioned_traits< ::std::uint64_t >::encode( field.type_tag, out );
+		versioned_traits< ::std::uint32_t >::encode( field.wire_size, out );
+	}
+}
+
+
+inline Schema decode_schema( void const * data, ::std::size_t size )
+{
+	unsigned char const * cursor = static_cast< unsigned char const * >( data );
+	unsigned char const * const end = cursor + size;
+	::std::uint32_t nb_fields;
+	Schema schema;
+
+	cursor = versioned_traits< ::std::uint32_t >::decode( cursor, end, nb_fields );
+
+	for ( ::std::uint32_t i = 0; i < nb_fields; ++i )
+	{
+		SchemaField field;
+		cursor = versioned_traits< ::std::string >::decode( cursor, end, field.name );
+		cursor = versioned_traits< ::std::uint64_t >::decode( cursor, end, field.type_tag );
+		cursor = versioned_traits< ::std::uint32_t >::decode( cursor, end, field.wire_size );
+		schema.fields.push_back( ::std::move( field ) );
+	}
+
+	schema.fingerprint = schema_fingerprint( schema.fields );
+	return schema;
+}
+
+
+
+class SchemaRegistry
+{
+public:
+	void add( Schema const & schema ) { _schemas.emplace( schema.fingerprint, schema ); }
+
+	template< class Implementor >
+	void add() { add( versioned_schema< Implementor >() ); }
+
+	Schema const * find( ::std::uint64_t fingerprint ) const
+	{
+		auto const it = _schemas.find( fingerprint );
+		return _schemas.end() == it ? nullptr : &it->second;
+	}
+
+private:
+	::std::map< ::std::uint64_t, Schema > _schemas;
+};
+
+
+
+// Record layout: 8-byte schema fingerprint, then every member in rank order.
+template< class Implementor >
+void encode_versioned( Implementor const & object, ::std::string & out )
+{
+	versioned_traits< ::std::uint64_t >::encode( versioned_schema< Implementor >().fingerprint, out );
+
+	for_each_member< Implementor >( [&]( auto, auto member )
+	{
+		using Member = decltype( member );
+		versioned_traits< typename Member::type >::encode( object.*Member::kPOINTER, out );
+	} );
+}
+
+
+
+// Decodes records of any registered version into Implementor. Records of the reader's own
+// version are decoded member by member; for other versions a field-mapping plan is built by
+// name on first sight and cached per writer fingerprint. Reader members missing from the
+// writer schema keep their value. One decoder per thread.
+template< class Implementor >
+class VersionedDecoder
+{
+	using Step = unsigned char const * (*)( unsigned char const *, unsigned char const *, ::std::uint32_t, Implementor & );
+
+	struct PlanStep
+	{
+		Step step;
+		::std::uint32_t wire_size;
+	};
+
+	using Plan = ::std::vector< PlanStep >;
+
+public:
+	explicit VersionedDecoder( SchemaRegistry const & registry )
+		: _registry( registry ), _last_fingerprint( versioned_schema< Implementor >().fingerprint ), _last_plan( nullptr ) {}
+
+	::std::size_t decode( void const * data, ::std::size_t size, Implementor & object )
+	{
+		unsigned char const * const begin = static_cast< unsigned char const * >( data );
+		unsigned char const * const end = begin + size;
+		::std::uint64_t fingerprint;
+		unsigned char const * cursor = versioned_traits< ::std::uint64_t >::decode( begin, end, fingerprint );
+
+		if ( versioned_schema< Implementor >().fingerprint == fingerprint )
+		{
+			for_each_member< Implementor >( [&]( auto, auto member )
+			{
+				using Member = decltype( member );
+				cursor = versioned_traits< typename Member::type >::decode( cursor, end, object.*Member::kPOINTER );
+			} );
+		}
+		else
+		{
+			for ( PlanStep const & plan_step : _plan( fingerprint ) )
+			{
+				cursor = plan_step.step( cursor, end, plan_step.wire_size, object );
+			}
+		}
+
+		return cursor - begin;
+	}
+
+	::std::size_t nb_plans() const { return _plans.size(); }
+
+private:
+	Plan const & _plan( ::std::uint64_t fingerprint )
+	{
+		if ( fingerprint == _last_fingerprint && nullptr != _last_plan ) return *_last_plan;
+
+		auto it = _plans.find( fingerprint );
+
+		if ( _plans.end() == it )
+		{
+			Schema const * const writer = _registry.find( fingerprint );
+			if ( nullptr == writer ) throw EUnknownSchema{};
+			it = _plans.emplace( fingerprint, _build_plan( *writer ) ).first;
+		}
+
+		_last_fingerprint = fingerprint;
+		_last_plan = &it->second;
+		return it->second;
+	}
+
+	static Plan _build_plan( Schema const & writer )
+	{
+		Plan plan;
+
+		for ( SchemaField const & field : writer.fields )
+		{
+			PlanStep plan_step{ field.wire_size ? &_skip_fixed : &_skip_prefixed, field.wire_size };
+
+			for_each_member< Implementor >( [&]( auto, auto member )
+			{
+				using Member = decltype( member );
+				using StorageType = typename Member::type;
+
+				if ( field.name == Member::kNAME && field.type_tag == type_tag< StorageType >() )
+				{
+					plan_step.step = &_decode_member< Member >;
+				}
+			} );
+
+			plan.push_back( plan_step );
+		}
+
+		return plan;
+	}
+
+	template< typename Member >
+	static unsigned char const * _decode_member( unsigned char const * cursor, unsigned char const * end, ::std::uint32_t, Implementor & object )
+	{
+		return versioned_traits< typename Member::type >::decode( cursor, end, object.*Member::kPOINTER );
+	}
+
+	static unsigned char const * _skip_bytes( unsigned char const * cursor, unsigned char const * end, ::std::uint32_t size )
+	{
+		if ( end - cursor < static_cast< ::std::ptrdiff_t >( size ) ) throw ETruncated{};
+		return cursor + size;
+	}
+
+	static unsigned char const * _skip_fixed( unsigned char const * cursor, unsigned char const * end, ::std::uint32_t wire_size, Implementor & )
+	{
+		return _skip_bytes( cursor, end, wire_size );
+	}
+
+	static unsigned char const * _skip_prefixed( unsigned char const * cursor, unsigned char const * end, ::std::uint32_t, Implementor & )
+	{
+		::std::uint32_t length;
+		cursor = versioned_traits< ::std::uint32_t >::decode( cursor, end, length );
+		return _skip_bytes( cursor, end, length );
+	}
+
+	SchemaRegistry const & _registry;
+	::std::unordered_map< ::std::uint64_t, Plan > _plans;
+	::std::uint64_t _last_fingerprint;
+	Plan const * _last_plan;
+};
+
+
+
+} // namespace insp
+} // namespace ap
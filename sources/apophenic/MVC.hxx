@@ -1,8 +1,28 @@
 #ifndef MVC_HXX
 #define MVC_HXX
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
 #include <typeinfo>
+#include <unordered_map>
 #include <utility>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
 
 
 namespace ap
@@ -20,6 +40,160 @@ class Spoke;
 class IHub {};
 
 
+// Epoch-based reclamation shared by all threads. Readers announce the epoch they enter
+// without any lock, writers unpublish what they replace and free it once every reader of
+// that epoch or an older one has left.
+class Epochs
+{
+	static constexpr ::std::uint64_t kIDLE = UINT64_MAX;
+
+	struct Reader
+	{
+		Reader() : epoch(kIDLE), taken(true), depth(0), next(nullptr) {}
+
+		::std::atomic<::std::uint64_t> epoch;
+		::std::atomic<bool> taken;
+		unsigned depth;
+		Reader * next;
+	};
+
+	// Slot of the current thread, taken over by another thread once it ends
+	struct Local
+	{
+		Local() : reader(acquire()) {}
+		~Local() { reader->taken.store(false); }
+
+		Reader * const reader;
+	};
+
+public:
+	// Read-side section, which may be nested. What was loaded within stays valid until the
+	// outermost one ends.
+	class Guard
+	{
+	public:
+		Guard() : _reader(local()) { if ( 0 == _reader.depth++ ) _reader.epoch.store(_epoch.load()); }
+		~Guard() { if ( 0 == --_reader.depth ) _reader.epoch.store(kIDLE); }
+
+		Guard(const Guard &) = delete;
+		Guard & operator=(const Guard &) = delete;
+
+	private:
+		Reader & _reader;
+	};
+
+	static bool reading() { return 0 != local().depth; }
+
+	// Starts a new epoch after something was unpublished, and returns the one its readers
+	// may still be in.
+	static ::std::uint64_t retire() { return _epoch.fetch_add(1); }
+
+	static bool passed(::std::uint64_t epoch)
+	{
+		for (const Reader * reader = _readers.load(); nullptr != reader; reader = reader->next)
+		{
+			if ( reader->epoch.load() <= epoch ) return false;
+		}
+
+		return true;
+	}
+
+	// Waits for the readers of the current epoch. Never called from a Guard, which would
+	// wait for itself.
+	static void synchronize()
+	{
+		const ::std::uint64_t epoch = retire();
+		while ( false == passed(epoch) ) ::std::this_thread::yield();
+	}
+
+private:
+	static Reader & local()
+	{
+		thread_local Local local;
+		return *local.reader;
+	}
+
+	static Reader * acquire()
+	{
+		for (Reader * reader = _readers.load(); nullptr != reader; reader = reader->next)
+		{
+			bool taken = false;
+			if ( reader->taken.compare_exchange_strong(taken, true) ) return reader;
+		}
+
+		Reader * const reader = new Reader();
+		reader->next = _readers.load();
+		while ( false == _readers.compare_exchange_weak(reader->next, reader) ) {}
+		return reader;
+	}
+
+	static inline ::std::atomic<::std::uint64_t> _epoch{1};
+	static inline ::std::atomic<Reader *> _readers{nullptr};
+};
+
+
+// Base of hubs whose spokes connect and disconnect from any thread while events are being
+// propagated. Changes are serialized by Writers, propagation reads the published snapshots
+// of ListenerRegistry and never waits. The outermost Writer that removed a listener waits
+// for the propagations which may still reach it, unless it runs within one: a view
+// disconnected by a handler must then outlive the propagations of other threads.
+// Views must disconnect before their destruction starts, their handlers may be running on
+// other threads until then. Listener::~Listener only leaves the registry once the view
+// around it is destroyed, too late to wait for them.
+class ConcurrentHub
+{
+public:
+	typedef ConcurrentHub concurrent_hub;
+
+	class Writer
+	{
+	public:
+		explicit Writer(ConcurrentHub * hub) : _hub(hub) { if ( nullptr != _hub ) _hub->lock(); }
+		~Writer() { if ( nullptr != _hub ) _hub->unlock(); }
+
+		Writer(const Writer &) = delete;
+		Writer & operator=(const Writer &) = delete;
+
+	private:
+		ConcurrentHub * const _hub;
+	};
+
+	ConcurrentHub() : _depth(0), _removed(false) {}
+	ConcurrentHub(const ConcurrentHub &) = delete;
+	ConcurrentHub & operator=(const ConcurrentHub &) = delete;
+
+	// Within a Writer, after a listener was unpublished.
+	void on_unpublished() { _removed = true; }
+
+private:
+	void lock()
+	{
+		_mutex.lock();
+		++_depth;
+	}
+
+	void unlock()
+	{
+		const bool removed = 0 == --_depth && _removed;
+		if ( removed ) _removed = false;
+		_mutex.unlock();
+
+		if ( removed && false == Epochs::reading() ) Epochs::synchronize();
+	}
+
+	::std::recursive_mutex _mutex;
+	unsigned _depth;
+	bool _removed;
+};
+
+
+template<typename TImplementor, typename = void>
+struct _has_concurrent_hub : ::std::false_type {};
+
+template<typename TImplementor>
+struct _has_concurrent_hub<TImplementor, ::std::void_t<typename TImplementor::concurrent_hub>> : ::std::true_type {};
+
+
 template<class TImplementor>
 class Hub : public IHub
 {
@@ -27,6 +201,8 @@ public:
 	template<class TOther, typename TContext>
 	void connect(Spoke<TOther> & spoke, TContext context)
 	{
+		const ConcurrentHub::Writer writer(concurrent());
+
 		if (	self()->is_connection_allowed(spoke, context)
 			&&	spoke.can_connect_to( *this )
 			)
@@ -47,6 +223,8 @@ public:
 	template<class TOther>
 	void disconnect(Spoke<TOther> & spoke)
 	{
+		const ConcurrentHub::Writer writer(concurrent());
+
 		if (	self()->is_connected(spoke)
 			&&	spoke.is_connected_to( *this )
 			)
@@ -61,6 +239,18 @@ public:
 	}
 
 private:
+	ConcurrentHub * concurrent()
+	{
+		if constexpr ( _has_concurrent_hub<TImplementor>::value )
+		{
+			return static_cast<typename TImplementor::concurrent_hub *>(self());
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
 	TImplementor * self() { return static_cast<TImplementor*>(this); }
 	const TImplementor * self() const { return static_cast<const TImplementor*>(this); }
 };
@@ -133,148 +323,1405 @@ template<typename TImplementations>
 class Inputer;
 template<typename TImplementations>
 class InputBridge;
+template<typename TImplementations, typename TEvent>
+class ListenerRegistry;
+template<typename TImplementations, typename... TEvents>
+class ListeningView;
+template<typename TConcrete, typename TImplementations, typename... TEvents>
+class StaticListeningView;
+template<typename TImplementations, typename... TConcretes>
+class StaticListeners;
+template<typename TImplementations, typename TEvent>
+class SubscriptionIndex;
+class EventBus;
+
+
+template<typename... TEvents>
+struct EventList {};
+
+
+struct ListenerHandle
+{
+	unsigned slot;
+	unsigned generation;
+};
 
 
+template<typename TImplementations, typename TEvent, typename = void>
+struct _is_subscribable : ::std::false_type {};
+
 template<typename TImplementations, typename TEvent>
-class Emiter<TImplementations, TEvent>
+struct _is_subscribable<TImplementations, TEvent, ::std::void_t<typename TImplementations::template type_data<TEvent>::subscription_key>>
+	: ::std::true_type {};
+
+
+template<typename TKey, typename = void>
+struct _has_prefixes : ::std::false_type {};
+
+template<typename TKey>
+struct _has_prefixes<TKey, ::std::void_t<decltype(TKey(::std::declval<const TKey &>(), ::std::size_t(), ::std::size_t()).size())>>
+	: ::std::true_type {};
+
+
+// What a listener subscribes to, when type_data<TEvent> has a subscription_key. Prefixes
+// need string-like keys.
+template<typename TImplementations, typename TEvent>
+class Subscriptions
 {
-	typedef typename TImplementations::event_emiter TImplementor;
-	typedef typename TImplementations::template type_data<TEvent>::init_data TInitData;
+	friend class SubscriptionIndex<TImplementations, TEvent>;
+
+public:
+	typedef typename TImplementations::template type_data<TEvent>::subscription_key TKey;
+
+	void key(const TKey & key) { _keys.push_back(key); }
+
+	void prefix(const TKey & prefix)
+	{
+		static_assert(_has_prefixes<TKey>::value, "Prefixes need keys with substrings");
+		_prefixes.push_back(prefix);
+	}
 
+private:
+	::std::vector<TKey> _keys;
+	::std::vector<TKey> _prefixes;
+};
+
+
+template<typename TImplementations, typename TEvent, typename = void>
+class Subscriber {};
+
+template<typename TImplementations, typename TEvent>
+class Subscriber<TImplementations, TEvent, typename ::std::enable_if<_is_subscribable<TImplementations, TEvent>::value>::type>
+{
 public:
+	// Asked once on registration. Listeners subscribing to nothing receive every event, others
+	// only the ones whose key matches. The emiter's filter applies to both.
+	virtual void subscribe(Subscriptions<TImplementations, TEvent> &) const {}
+};
+
+
+// Registered listeners by the keys and key prefixes they subscribed to, so that an event
+// reaches its subscribers without asking every listener. Listeners subscribing to nothing
+// are kept apart and reached for every key.
+template<typename TImplementations, typename TEvent>
+class SubscriptionIndex
+{
 	typedef Listener<TImplementations, TEvent> TListener;
 
-	void propagate_event(const TEvent & event) const
+	static constexpr ::std::size_t kSUBSCRIBED = static_cast<::std::size_t>(-1);
+
+	struct Entry
+	{
+		TListener * listener;
+		::std::size_t position;
+		::std::vector<typename Subscriptions<TImplementations, TEvent>::TKey> keys;
+		::std::vector<typename Subscriptions<TImplementations, TEvent>::TKey> prefixes;
+		unsigned long stamp;
+	};
+
+public:
+	typedef typename Subscriptions<TImplementations, TEvent>::TKey TKey;
+
+	SubscriptionIndex() : _stamp(0), _depth(0) {}
+
+	void add(TListener & listener)
 	{
-		for (auto & listener : self()->template listeners<TEvent>())
+		Subscriptions<TImplementations, TEvent> subscriptions;
+		listener.subscribe(subscriptions);
+
+		Entry & entry = _entries[&listener];
+		entry.listener = &listener;
+		entry.keys = ::std::move(subscriptions._keys);
+		entry.prefixes = ::std::move(subscriptions._prefixes);
+		entry.stamp = _stamp;
+		entry.position = kSUBSCRIBED;
+
+		if ( entry.keys.empty() && entry.prefixes.empty() )
 		{
-			if (self()->filter(event, listener))
-			{
-				listener->handle_event(event);
-			}
+			entry.position = _unsubscribed.size();
+			_unsubscribed.push_back(&listener);
+		}
+
+		for (const TKey & key : entry.keys) _keys[key].push_back(&entry);
+
+		for (const TKey & prefix : entry.prefixes)
+		{
+			_prefixes[prefix].push_back(&entry);
+			++_lengths[prefix.size()];
 		}
 	}
 
-	template<typename TGeneric>
-	void propagate_generic_event(const TGeneric & generic) const
+	void remove(const TListener & listener)
 	{
-		TEvent const * event_p = nullptr;
+		auto found = _entries.find(&listener);
+		if ( _entries.end() == found ) return;
 
-		try
+		Entry & entry = found->second;
+
+		if ( kSUBSCRIBED != entry.position )
 		{
-			event_p = &self()->template cast<TEvent,TGeneric>(generic);
+			_unsubscribed[entry.position] = _unsubscribed.back();
+			_entries[_unsubscribed[entry.position]].position = entry.position;
+			_unsubscribed.pop_back();
 		}
-		catch( ::std::bad_cast const & ) {}
 
-		if ( nullptr != event_p )
+		for (const TKey & key : entry.keys) erase(_keys, key, &entry);
+
+		for (const TKey & prefix : entry.prefixes)
 		{
-			propagate_event(*event_p);
+			erase(_prefixes, prefix, &entry);
+			if ( 0 == --_lengths[prefix.size()] ) _lengths.erase(prefix.size());
 		}
+
+		_entries.erase(found);
 	}
 
-	template<typename TEventIterator>
-	void propagate_events(TEventIterator start, TEventIterator finish) const
+	bool contains(const TListener * listener) const { return _entries.end() != _entries.find(listener); }
+
+	// Listeners subscribed to key or to one of its prefixes, once each.
+	void collect(const TKey & key, ::std::vector<TListener *> & matches) const
 	{
-		while(start != finish) propagate_generic_event<>( **start++ );
+		const unsigned long stamp = ++_stamp;
+		gather(_keys, key, stamp, matches);
+
+		if constexpr ( _has_prefixes<TKey>::value )
+		{
+			for (const auto & length : _lengths)
+			{
+				if ( key.size() < length.first ) break;
+				gather(_prefixes, TKey(key, 0, length.first), stamp, matches);
+			}
+		}
 	}
 
-	template<typename TGeneric>
-	static constexpr bool can_register_listener(const Listener<TImplementations,TGeneric> & listener)
+	// Unsubscribed listeners, then the subscribers of key, as they were on the call. Listeners
+	// removed by a handler are skipped. Matches are gathered in a buffer kept per nesting
+	// level, so handlers may propagate in turn.
+	template<typename TFunction>
+	void for_each_match(const TKey & key, const TFunction & function) const
 	{
-		return std::is_same<TGeneric,TEvent>();
+		if ( _matches.size() == _depth ) _matches.emplace_back();
+		::std::vector<TListener *> & matches = _matches[_depth++];
+
+		matches.assign(_unsubscribed.begin(), _unsubscribed.end());
+		collect(key, matches);
+
+		try
+		{
+			for (TListener * listener : matches)
+			{
+				if ( contains(listener) ) function(listener);
+			}
+		}
+		catch (...)
+		{
+			--_depth;
+			throw;
+		}
+
+		--_depth;
 	}
 
-	template<typename TOther>
-	bool on_listener_registered(TOther & other)
+	const ::std::vector<TListener *> & unsubscribed() const { return _unsubscribed; }
+
+private:
+	typedef ::std::unordered_map<TKey, ::std::vector<Entry *>> TBuckets;
+
+	static void gather(const TBuckets & buckets, const TKey & key, unsigned long stamp, ::std::vector<TListener *> & matches)
 	{
-		TListener* const listener = dynamic_cast<TListener*>(&other);
+		auto found = buckets.find(key);
+		if ( buckets.end() == found ) return;
 
-		if (nullptr != listener)
+		for (Entry * entry : found->second)
 		{
-			register_listener(*listener);
-			return true;
+			if ( stamp == entry->stamp ) continue;
+			entry->stamp = stamp;
+			matches.push_back(entry->listener);
 		}
-
-		return false;
 	}
 
-	void register_listener(TListener & listener)
+	static void erase(TBuckets & buckets, const TKey & key, Entry * entry)
 	{
-		on_registered_cb( listener );
-		listener.initialize( get_init_data( listener ) );
+		auto found = buckets.find(key);
+		::std::vector<Entry *> & bucket = found->second;
+		bucket.erase(::std::find(bucket.begin(), bucket.end(), entry));
+		if ( bucket.empty() ) buckets.erase(found);
 	}
 
-protected:
-	virtual void on_registered_cb(TListener & listener) = 0;
-	virtual TInitData get_init_data(const TListener & listener) = 0;
+	::std::unordered_map<const TListener *, Entry> _entries;
+	::std::vector<TListener *> _unsubscribed;
+	TBuckets _keys;
+	TBuckets _prefixes;
+	::std::map<::std::size_t, unsigned> _lengths;
+	mutable unsigned long _stamp;
+	mutable ::std::deque<::std::vector<TListener *>> _matches;
+	mutable ::std::size_t _depth;
+};
 
-private:
-	TImplementor * self() { return static_cast<TImplementor*>(this); }
-	const TImplementor * self() const { return static_cast<const TImplementor*>(this); }
+
+enum class eChange
+{
+		CREATION
+	,	MODIFICATION
+	,	DESTRUCTION
 };
 
 
-template<typename TImplementations, typename TEvent, typename... TEvents>
-class Emiter<TImplementations, TEvent, TEvents...>
-	: public Emiter<TImplementations, TEvent>
-	, public Emiter<TImplementations, TEvents...>
+template<typename TImplementations, typename TEvent, typename = void>
+struct _is_conflated : ::std::false_type {};
+
+template<typename TImplementations, typename TEvent>
+struct _is_conflated<TImplementations, TEvent, ::std::void_t<typename TImplementations::template type_data<TEvent>::conflation_key>>
+	: ::std::true_type {};
+
+
+// Undelivered events of each listener, when type_data<TEvent> has a conflation_key. A
+// modification replaces the pending one of its key, a destruction drops the pending
+// modifications, and the creation too if it is pending. So each key holds at most a
+// destruction, a creation and a modification, whatever the rate of changes.
+template<typename TImplementations, typename TEvent>
+class ConflatingQueues
 {
-	typedef typename TImplementations::event_emiter TImplementor;
-	typedef Emiter<TImplementations, TEvent> TCurrent;
-	typedef Emiter<TImplementations, TEvents...> TNext;
+	typedef Listener<TImplementations, TEvent> TListener;
+	typedef ::std::shared_ptr<const TEvent> TShared;
+
+	struct Change
+	{
+		eChange change;
+		TShared event;
+	};
 
 public:
-	template<typename TGeneric>
-	void propagate_generic_event(const TGeneric & generic) const
+	typedef typename TImplementations::template type_data<TEvent>::conflation_key TKey;
+
+private:
+	struct Queue
 	{
-		TCurrent::propagate_generic_event( generic );
-		TNext::propagate_generic_event( generic );
-	}
+		Queue() : size(0) {}
 
-	template<typename TEventIterator>
-	void propagate_events(TEventIterator start, TEventIterator finish) const
+		::std::vector<::std::pair<TKey, ::std::vector<Change>>> pending;
+		::std::unordered_map<TKey, ::std::size_t> positions;
+		::std::size_t size;
+	};
+
+public:
+	ConflatingQueues() : _depth(0) {}
+
+	void push(TListener & listener, const TKey & key, eChange change, const TShared & event)
 	{
-		while(start != finish) propagate_generic_event<>( **start++ );
+		Queue & queue = _queues[&listener];
+		auto position = queue.positions.find(key);
+
+		if ( queue.positions.end() == position )
+		{
+			position = queue.positions.emplace(key, queue.pending.size()).first;
+			queue.pending.emplace_back(key, ::std::vector<Change>());
+		}
+
+		::std::vector<Change> & changes = queue.pending[position->second].second;
+		queue.size -= changes.size();
+
+		if ( eChange::DESTRUCTION == change )
+		{
+			while ( false == changes.empty() && eChange::MODIFICATION == changes.back().change ) changes.pop_back();
+
+			if ( false == changes.empty() && eChange::CREATION == changes.back().change )
+			{
+				changes.pop_back();
+			}
+			else
+			{
+				changes.push_back(Change{change, event});
+			}
+		}
+		else if ( eChange::MODIFICATION == change && false == changes.empty() && eChange::MODIFICATION == changes.back().change )
+		{
+			changes.back().event = event;
+		}
+		else
+		{
+			changes.push_back(Change{change, event});
+		}
+
+		queue.size += changes.size();
 	}
 
-	template<typename TGeneric>
-	static constexpr bool can_register_listener(const Listener<TImplementations,TGeneric> & listener)
+	// Hands listener its pending events in one handle_events call, keys in the order they
+	// were first changed.
+	void drain(TListener & listener)
 	{
-		return TCurrent::template can_register_listener<TGeneric>(listener)
-			|| TNext::template can_register_listener<TGeneric>(listener);
+		auto found = _queues.find(&listener);
+		if ( _queues.end() == found ) return;
+
+		const Queue queue = ::std::move(found->second);
+		_queues.erase(found);
+
+		::std::vector<const TEvent *> events;
+		events.reserve(queue.size);
+
+		for (const auto & pending : queue.pending)
+		{
+			for (const Change & change : pending.second) events.push_back(change.event.get());
+		}
+
+		if ( false == events.empty() ) listener.handle_events(events.data(), events.size());
 	}
 
-	template<typename TOther>
-	bool on_listener_registered(TOther & other)
+	// Drains the listeners of [first, last), as they were on the call. Listeners removed by a
+	// handler lost their queue and are skipped. They are gathered in a buffer kept per nesting
+	// level, so handlers may deliver in turn.
+	template<typename TIterator>
+	void drain(TIterator first, TIterator last)
 	{
-		typename TCurrent::TListener* const listener =
-			dynamic_cast<typename TCurrent::TListener*>(&other);
-		bool at_least_one = false;
+		if ( _drained.size() == _depth ) _drained.emplace_back();
+		::std::vector<TListener *> & listeners = _drained[_depth++];
 
-		if ( nullptr != listener )
+		listeners.assign(first, last);
+
+		try
 		{
-			at_least_one = true;
-			TCurrent::register_listener( *listener );
+			for (TListener * listener : listeners) drain(*listener);
+		}
+		catch (...)
+		{
+			--_depth;
+			throw;
 		}
 
-		return at_least_one | TNext::on_listener_registered( other );
+		--_depth;
+	}
+
+	void remove(const TListener & listener) { _queues.erase(&listener); }
+
+	::std::size_t size(const TListener & listener) const
+	{
+		auto found = _queues.find(&listener);
+		return _queues.end() == found ? 0 : found->second.size;
 	}
 
 private:
-	TImplementor * self() { return static_cast<TImplementor*>(this); }
-	const TImplementor * self() const { return static_cast<const TImplementor*>(this); }
+	::std::unordered_map<const TListener *, Queue> _queues;
+	::std::deque<::std::vector<TListener *>> _drained;
+	::std::size_t _depth;
 };
 
 
+// Listeners of one event type, kept contiguous for fan-out. Removal swaps the last listener
+// into the hole, registration handles stay valid through it. Listeners remember their
+// registry and leave it when destroyed.
+// Once shared with a ConcurrentHub, every change is made under its Writer and publishes a
+// new snapshot, which other threads read within an Epochs::Guard.
+// Events with a subscription_key also have their listeners indexed by subscription.
 template<typename TImplementations, typename TEvent>
-class Listener<TImplementations, TEvent>
+class ListenerRegistry
 {
-	typedef typename TImplementations::template type_data<TEvent>::init_data TInitData;
+	typedef Listener<TImplementations, TEvent> TListener;
 
-public:
-	virtual void handle_event(const TEvent & event) = 0;
-	virtual void initialize(TInitData && event) = 0;
-};
+	struct Slot
+	{
+		unsigned position;
+		unsigned generation;
+	};
+
+	struct NoIndex
+	{
+		void add(TListener &) {}
+		void remove(const TListener &) {}
+	};
+
+	typedef typename ::std::conditional<
+			_is_subscribable<TImplementations, TEvent>::value
+		,	SubscriptionIndex<TImplementations, TEvent>
+		,	NoIndex
+		>::type TIndex;
+
+	struct NoQueues
+	{
+		void remove(const TListener &) {}
+	};
+
+	typedef typename ::std::conditional<
+			_is_conflated<TImplementations, TEvent>::value
+		,	ConflatingQueues<TImplementations, TEvent>
+		,	NoQueues
+		>::type TQueues;
+
+public:
+	typedef TListener * const * const_iterator;
+	typedef void (*TObserver)(const void * context, TListener & listener);
+
+	// Listeners when published. The ones removed since are nulled in every snapshot that
+	// may still be read.
+	struct Snapshot
+	{
+		explicit Snapshot(const ::std::vector<TListener *> & from) : listeners(from.size()), retired(0)
+		{
+			for (::std::size_t i = 0; i < from.size(); ++i) listeners[i].store(from[i], ::std::memory_order_relaxed);
+		}
+
+		void erase(const TListener & removed)
+		{
+			for (::std::atomic<TListener *> & listener : listeners)
+			{
+				if ( &removed == listener.load(::std::memory_order_relaxed) ) listener.store(nullptr);
+			}
+		}
+
+		::std::vector<::std::atomic<TListener *>> listeners;
+		::std::uint64_t retired;
+	};
+
+	ListenerRegistry() : _observer(nullptr), _context(nullptr), _hub(nullptr), _snapshot(nullptr), _depth(0) {}
+	ListenerRegistry(const ListenerRegistry &) = delete;
+	ListenerRegistry & operator=(const ListenerRegistry &) = delete;
+
+	~ListenerRegistry()
+	{
+		for (TListener * listener : _listeners) listener->_registry = nullptr;
+		for (Snapshot * snapshot : _retired) delete snapshot;
+		delete _snapshot.load();
+	}
+
+	ListenerHandle add(TListener & listener)
+	{
+		const ConcurrentHub::Writer writer(_hub);
+
+		if ( nullptr != listener._registry ) listener._registry->remove(listener);
+
+		_listeners.reserve(_listeners.size() + 1);
+		_owners.reserve(_owners.size() + 1);
+
+		if ( _free.empty() )
+		{
+			_free.push_back(static_cast<unsigned>(_slots.size()));
+			_slots.push_back(Slot{0u, 0u});
+		}
+
+		const unsigned slot = _free.back();
+		_free.pop_back();
+
+		_slots[slot].position = static_cast<unsigned>(_listeners.size());
+		_listeners.push_back(&listener);
+		_owners.push_back(slot);
+
+		listener._registry = this;
+		listener._handle = ListenerHandle{slot, _slots[slot].generation};
+		_index.add(listener);
+
+		if ( nullptr != _hub ) publish();
+		return listener._handle;
+	}
+
+	bool remove(ListenerHandle handle)
+	{
+		const ConcurrentHub::Writer writer(_hub);
+
+		if ( false == contains(handle) ) return false;
+
+		Slot & slot = _slots[handle.slot];
+		const unsigned last = static_cast<unsigned>(_listeners.size() - 1);
+		TListener & removed = *_listeners[slot.position];
+
+		removed._registry = nullptr;
+		_listeners[slot.position] = _listeners[last];
+		_owners[slot.position] = _owners[last];
+		_slots[_owners[last]].position = slot.position;
+		_listeners.pop_back();
+		_owners.pop_back();
+
+		++slot.generation;
+		_free.push_back(handle.slot);
+		_index.remove(removed);
+		_queues.remove(removed);
+
+		if ( nullptr != _hub ) unpublish(removed);
+		if ( nullptr != _observer ) _observer(_context, removed);
+		return true;
+	}
+
+	bool remove(TListener & listener) { return this == listener._registry && remove(listener._handle); }
+
+	bool contains(ListenerHandle handle) const
+	{
+		return	handle.slot < _slots.size()
+			&&	handle.generation == _slots[handle.slot].generation;
+	}
+
+	const_iterator begin() const { return _listeners.data(); }
+	const_iterator end() const { return _listeners.data() + _listeners.size(); }
+	::std::size_t size() const { return _listeners.size(); }
+	bool empty() const { return _listeners.empty(); }
+	TListener * operator[](::std::size_t position) const { return _listeners[position]; }
+
+	// Calls function(TListener *) on the listeners as they were on the call. Listeners removed
+	// by a handler are skipped, the one swapped into their place is not. They are copied with
+	// their handle in a buffer kept per nesting level, so handlers may propagate in turn.
+	template<typename TFunction>
+	void for_each(const TFunction & function) const
+	{
+		if ( _walks.size() == _depth ) _walks.emplace_back();
+		::std::vector<::std::pair<TListener *, ListenerHandle>> & walk = _walks[_depth++];
+
+		walk.clear();
+		for (::std::size_t i = 0; i < _listeners.size(); ++i)
+		{
+			walk.emplace_back(_listeners[i], ListenerHandle{_owners[i], _slots[_owners[i]].generation});
+		}
+
+		try
+		{
+			for (const auto & entry : walk)
+			{
+				if ( contains(entry.second) ) function(entry.first);
+			}
+		}
+		catch (...)
+		{
+			--_depth;
+			throw;
+		}
+
+		--_depth;
+	}
+
+	// Called after each removal, including the ones of listeners being destroyed.
+	void observe(TObserver observer, const void * context)
+	{
+		_observer = observer;
+		_context = context;
+	}
+
+	void share(ConcurrentHub & hub)
+	{
+		if ( nullptr != _hub ) return;
+
+		const ConcurrentHub::Writer writer(&hub);
+		_hub = &hub;
+		publish();
+	}
+
+	// nullptr until shared.
+	const Snapshot * snapshot() const { return _snapshot.load(); }
+
+	template<typename TOther = TEvent>
+	const SubscriptionIndex<TImplementations, TOther> & subscriptions() const { return _index; }
+
+	// Pending events of the listeners, filled and drained by the emiter.
+	template<typename TOther = TEvent>
+	ConflatingQueues<TImplementations, TOther> & queues() const { return _queues; }
+
+private:
+	void publish()
+	{
+		Snapshot * const previous = _snapshot.exchange(new Snapshot(_listeners));
+
+		if ( nullptr != previous )
+		{
+			previous->retired = Epochs::retire();
+			_retired.push_back(previous);
+		}
+
+		for (::std::size_t i = 0; i < _retired.size(); )
+		{
+			if ( Epochs::passed(_retired[i]->retired) )
+			{
+				delete _retired[i];
+				_retired[i] = _retired.back();
+				_retired.pop_back();
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	void unpublish(const TListener & removed)
+	{
+		_snapshot.load()->erase(removed);
+		for (Snapshot * snapshot : _retired) snapshot->erase(removed);
+
+		publish();
+		_hub->on_unpublished();
+	}
+
+	::std::vector<TListener *> _listeners;
+	::std::vector<unsigned> _owners;
+	::std::vector<Slot> _slots;
+	::std::vector<unsigned> _free;
+	TObserver _observer;
+	const void * _context;
+	ConcurrentHub * _hub;
+	::std::atomic<Snapshot *> _snapshot;
+	::std::vector<Snapshot *> _retired;
+	TIndex _index;
+	mutable TQueues _queues;
+	mutable ::std::deque<::std::vector<::std::pair<TListener *, ListenerHandle>>> _walks;
+	mutable ::std::size_t _depth;
+};
+
+
+// Where the TEvents are within a generic event, found without throwing: statically when
+// TGeneric converts to them, by dynamic type otherwise. Offsets depend only on the dynamic
+// type, each thread caches them by type index after a first set of dynamic_casts.
+constexpr ::std::ptrdiff_t kNO_ROUTE = PTRDIFF_MIN;
+
+
+template<typename TGeneric, typename... TEvents>
+class EventRoutes
+{
+public:
+	typedef ::std::array<::std::ptrdiff_t, sizeof...(TEvents)> TOffsets;
+
+	template<typename TEvent>
+	static const TEvent * route(const TGeneric & generic)
+	{
+		if constexpr ( ::std::is_convertible<const TGeneric *, const TEvent *>::value )
+		{
+			return &generic;
+		}
+		else if constexpr ( ::std::is_polymorphic<TGeneric>::value && ::std::is_class<TEvent>::value )
+		{
+			return dynamic_cast<const TEvent *>(&generic);
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
+	static const TOffsets & offsets(const TGeneric & generic)
+	{
+		thread_local ::std::unordered_map<::std::type_index, TOffsets> cache;
+		const ::std::type_index type(typeid(generic));
+		auto found = cache.find(type);
+
+		if ( cache.end() == found )
+		{
+			found = cache.emplace(type, TOffsets{{ offset<TEvents>(generic)... }}).first;
+		}
+
+		return found->second;
+	}
+
+private:
+	template<typename TEvent>
+	static ::std::ptrdiff_t offset(const TGeneric & generic)
+	{
+		const TEvent * const event = route<TEvent>(generic);
+
+		return nullptr == event
+			? kNO_ROUTE
+			: reinterpret_cast<const char *>(event) - reinterpret_cast<const char *>(&generic);
+	}
+};
+
+
+template<typename TImplementor, typename = void>
+struct _has_event_bus : ::std::false_type {};
+
+template<typename TImplementor>
+struct _has_event_bus<TImplementor, ::std::void_t<typename TImplementor::event_bus>> : ::std::true_type {};
+
+
+template<typename TImplementor, typename TEvent, typename TGeneric, typename = void>
+struct _has_cast : ::std::false_type {};
+
+template<typename TImplementor, typename TEvent, typename TGeneric>
+struct _has_cast<TImplementor, TEvent, TGeneric, decltype(void(::std::declval<const TImplementor &>().template cast<TEvent,TGeneric>(::std::declval<const TGeneric &>())))>
+	: ::std::true_type {};
+
+
+template<typename TImplementations, typename TEvent>
+class Emiter<TImplementations, TEvent>
+{
+	typedef typename TImplementations::event_emiter TImplementor;
+	typedef typename TImplementations::template type_data<TEvent>::init_data TInitData;
+
+	template<typename TOther, typename = void>
+	struct _has_listeners : ::std::false_type {};
+
+	template<typename TOther>
+	struct _has_listeners<TOther, decltype(void(::std::declval<const TOther &>().template listeners<TEvent>()))> : ::std::true_type {};
+
+	template<typename TOther, typename = void>
+	struct _has_static_listeners : ::std::false_type {};
+
+	template<typename TOther>
+	struct _has_static_listeners<TOther, ::std::void_t<typename TOther::static_listeners>> : ::std::true_type {};
+
+	template<typename TOther>
+	struct _is_indexed
+		: ::std::bool_constant<_is_subscribable<TImplementations, TEvent>::value && false == _has_listeners<TOther>::value> {};
+
+	template<typename TOther, typename = void>
+	struct _has_event_change : ::std::false_type {};
+
+	template<typename TOther>
+	struct _has_event_change<TOther, decltype(void(::std::declval<const TOther &>().event_change(::std::declval<const TEvent &>())))>
+		: ::std::true_type {};
+
+	// Events kept for delivery later, by an event_bus or by conflating queues.
+	template<typename TOther>
+	struct _is_deferred
+		: ::std::bool_constant<_has_event_bus<TOther>::value || _is_conflated<TImplementations, TEvent>::value> {};
+
+	template<typename TEventList>
+	struct _listens;
+
+	template<typename... TListened>
+	struct _listens<EventList<TListened...>> : ::std::disjunction<::std::is_same<TEvent,TListened>...> {};
+
+public:
+	typedef Listener<TImplementations, TEvent> TListener;
+
+	Emiter()
+	{
+		if constexpr ( _has_event_bus<TImplementor>::value )
+		{
+			_registry.observe(&Emiter::on_registry_removal, this);
+		}
+	}
+
+	// Goes through the implementor's listeners<TEvent>() when it has one, through the
+	// registered listeners otherwise, then through its StaticListeners if any. Registered
+	// listeners disconnected by a handler are skipped, the others all get the event.
+	// With an event_bus, the event is copied once and delivered by the bus. With a
+	// concurrent_hub, the registered listeners are read from their last published snapshot.
+	// With a subscription_key, only the registered listeners subscribed to the implementor's
+	// event_key(event) and the ones subscribed to nothing are considered. With a
+	// conflation_key, the event is copied once and queued until deliver_pending.
+	void propagate_event(const TEvent & event) const
+	{
+		if constexpr ( _is_deferred<TImplementor>::value )
+		{
+			propagate_shared(::std::make_shared<const TEvent>(event));
+		}
+		else
+		{
+			for_each_listener(event, [this, &event](TListener * listener) { deliver(event, listener); });
+
+			if constexpr ( _has_static_listeners<TImplementor>::value )
+			{
+				static_cast<const typename TImplementor::static_listeners *>(self())->dispatch_static(
+						event
+					,	[this](const TEvent & filtered, TListener * listener) { return self()->filter(filtered, listener); }
+					);
+			}
+		}
+	}
+
+	// Posts the same payload to every accepting listener through the implementor's
+	// event_bus, or queues it for them when conflated, or propagates it synchronously.
+	// Conflation keys it by the implementor's event_key(event), and by its event_change(event)
+	// when it has one, every event being a modification otherwise.
+	void propagate_shared(::std::shared_ptr<const TEvent> event) const
+	{
+		if constexpr ( _has_event_bus<TImplementor>::value )
+		{
+			static_assert(false == _is_conflated<TImplementations, TEvent>::value, "Conflated events are delivered by deliver_pending");
+			const typename TImplementor::event_bus & bus = *self();
+			::std::vector<TListener *> overflowed;
+
+			auto post = [this, &bus, &event, &overflowed](TListener * listener)
+			{
+				if ( self()->filter(*event, listener) && false == bus.post(listener, event) ) overflowed.push_back(listener);
+			};
+
+			for_each_listener(*event, post);
+
+			if constexpr ( _has_static_listeners<TImplementor>::value )
+			{
+				static_cast<const typename TImplementor::static_listeners *>(self())->template for_each_static<TEvent>(post);
+			}
+
+			for (TListener * listener : overflowed) evict(*listener);
+		}
+		else if constexpr ( _is_conflated<TImplementations, TEvent>::value )
+		{
+			static_assert(false == _has_listeners<TImplementor>::value, "Conflation needs registered listeners");
+			static_assert(false == _has_static_listeners<TImplementor>::value, "StaticListeners are not conflated");
+			static_assert(false == _has_concurrent_hub<TImplementor>::value, "Conflating queues are not shared with concurrent readers");
+
+			const auto & key = self()->event_key(*event);
+			const eChange change = change_of(*event);
+			ConflatingQueues<TImplementations, TEvent> & queues = _registry.queues();
+
+			for_each_listener(*event, [this, &event, &key, change, &queues](TListener * listener)
+			{
+				if ( self()->filter(*event, listener) ) queues.push(*listener, key, change, event);
+			});
+		}
+		else
+		{
+			propagate_event(*event);
+		}
+	}
+
+	// Hands every registered listener its conflated events, in one handle_events call each.
+	// Listeners disconnected by a handler meanwhile are skipped, the others all delivered.
+	void deliver_pending() const
+	{
+		if constexpr ( _is_conflated<TImplementations, TEvent>::value )
+		{
+			_registry.queues().drain(_registry.begin(), _registry.end());
+		}
+	}
+
+	template<typename TOther>
+	void deliver_pending(TOther & other) const
+	{
+		if constexpr ( _is_conflated<TImplementations, TEvent>::value && ::std::is_base_of<TListener, TOther>::value )
+		{
+			_registry.queues().drain(static_cast<TListener &>(other));
+		}
+	}
+
+	// Goes through the implementor's cast<TEvent,TGeneric>() when it has one, treating
+	// bad_cast as another event type, through route_generic_event otherwise.
+	template<typename TGeneric>
+	void propagate_generic_event(const TGeneric & generic) const
+	{
+		if constexpr ( false == _has_cast<TImplementor,TEvent,TGeneric>::value )
+		{
+			route_generic_event(generic);
+		}
+		else
+		{
+			TEvent const * event_p = nullptr;
+
+			try
+			{
+				event_p = &self()->template cast<TEvent,TGeneric>(generic);
+			}
+			catch( ::std::bad_cast const & ) {}
+
+			if ( nullptr != event_p )
+			{
+				propagate_event(*event_p);
+			}
+		}
+	}
+
+	template<typename TEventIterator>
+	void propagate_events(TEventIterator start, TEventIterator finish) const
+	{
+		while(start != finish) propagate_generic_event<>( **start++ );
+	}
+
+	// Same as propagate_generic_event without cast<>(), nor any exception.
+	template<typename TGeneric>
+	void route_generic_event(const TGeneric & generic) const
+	{
+		TEvent const * const event_p = EventRoutes<TGeneric,TEvent>::template route<TEvent>(generic);
+
+		if ( nullptr != event_p )
+		{
+			propagate_event(*event_p);
+		}
+	}
+
+	template<typename TEventIterator>
+	void route_events(TEventIterator start, TEventIterator finish) const
+	{
+		while(start != finish) route_generic_event<>( **start++ );
+	}
+
+	// Hands every listener the events it accepts through handle_events, one call per run of
+	// accepted events.
+	// With an event_bus or a conflation_key, the events are propagated one by one instead.
+	void propagate_batch(const TEvent * const * events, ::std::size_t count) const
+	{
+		if constexpr ( _is_deferred<TImplementor>::value )
+		{
+			for (::std::size_t i = 0; i < count; ++i) propagate_event(*events[i]);
+			return;
+		}
+
+		if ( 0 == count ) return;
+
+		if constexpr ( _is_indexed<TImplementor>::value )
+		{
+			deliver_subscribed(events, count);
+		}
+		else
+		{
+			for_each_listener([this, events, count](TListener * listener) { deliver_batch(events, count, listener); });
+		}
+
+		if constexpr ( _has_static_listeners<TImplementor>::value )
+		{
+			static_cast<const typename TImplementor::static_listeners *>(self())->template for_each_static<TEvent>(
+				[this, events, count](TListener * listener) { deliver_batch(events, count, listener); }
+				);
+		}
+	}
+
+	// Routes the generic events like route_events, then propagates them as one batch.
+	template<typename TEventIterator>
+	void propagate_batch(TEventIterator start, TEventIterator finish) const
+	{
+		TBatches batch;
+		while(start != finish) collect( **start++, batch );
+		deliver_batches( batch );
+	}
+
+	template<typename TGeneric>
+	static constexpr bool can_register_listener(const Listener<TImplementations,TGeneric> & listener)
+	{
+		return std::is_same<TGeneric,TEvent>();
+	}
+
+	template<typename TOther>
+	bool on_listener_registered(TOther & other)
+	{
+		TListener* const listener = dynamic_cast<TListener*>(&other);
+
+		if (nullptr != listener)
+		{
+			register_listener(*listener);
+			return true;
+		}
+
+		return false;
+	}
+
+	template<typename TOther>
+	bool on_listener_unregistered(TOther & other)
+	{
+		TListener* const listener = dynamic_cast<TListener*>(&other);
+		return nullptr != listener && _registry.remove(*listener);
+	}
+
+	// Same as on_listener_registered for views listing their events in listened_events,
+	// resolved at compile time. Without REGISTERED, only the callbacks run and the view is
+	// expected to be held elsewhere, as in StaticListeners.
+	template<bool REGISTERED = true, typename TOther>
+	bool on_static_listener_registered(TOther & other)
+	{
+		if constexpr ( _listens<typename TOther::listened_events>::value )
+		{
+			if constexpr ( REGISTERED )
+			{
+				register_listener(other);
+			}
+			else
+			{
+				TListener & listener = other;
+				attach( listener );
+				on_registered_cb( listener );
+				listener.initialize( get_init_data( listener ) );
+			}
+
+			return true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	template<typename TOther>
+	bool on_static_listener_unregistered(TOther & other)
+	{
+		if constexpr ( _listens<typename TOther::listened_events>::value )
+		{
+			return _registry.remove(static_cast<TListener&>(other));
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	void register_listener(TListener & listener)
+	{
+		if constexpr ( _has_concurrent_hub<TImplementor>::value )
+		{
+			_registry.share( static_cast<typename TImplementor::concurrent_hub &>(*self()) );
+		}
+
+		attach( listener );
+		_registry.add( listener );
+		on_registered_cb( listener );
+		listener.initialize( get_init_data( listener ) );
+	}
+
+	template<typename TOther = TEvent>
+	const ListenerRegistry<TImplementations, TOther> & registered_listeners() const
+	{
+		static_assert(::std::is_same<TOther,TEvent>::value, "Not an emited event");
+		return _registry;
+	}
+
+protected:
+	virtual void on_registered_cb(TListener & listener) = 0;
+	virtual TInitData get_init_data(const TListener & listener) = 0;
+
+	void route_at(const char * generic, const ::std::ptrdiff_t * offsets) const
+	{
+		if ( kNO_ROUTE != *offsets )
+		{
+			propagate_event(*reinterpret_cast<const TEvent *>(generic + *offsets));
+		}
+	}
+
+	typedef ::std::vector<const TEvent *> TBatches;
+
+	template<typename TGeneric>
+	void collect(const TGeneric & generic, TBatches & batch) const
+	{
+		TEvent const * const event_p = EventRoutes<TGeneric,TEvent>::template route<TEvent>(generic);
+		if ( nullptr != event_p ) batch.push_back(event_p);
+	}
+
+	void collect_at(const char * generic, const ::std::ptrdiff_t * offsets, TBatches & batch) const
+	{
+		if ( kNO_ROUTE != *offsets ) batch.push_back(reinterpret_cast<const TEvent *>(generic + *offsets));
+	}
+
+	void deliver_batches(const TBatches & batch) const { propagate_batch(batch.data(), batch.size()); }
+
+private:
+	template<typename TFunction>
+	void for_each_listener(const TFunction & function) const
+	{
+		if constexpr ( _has_listeners<TImplementor>::value )
+		{
+			for (auto & listener : self()->template listeners<TEvent>())
+			{
+				function(listener);
+			}
+		}
+		else if constexpr ( _has_concurrent_hub<TImplementor>::value )
+		{
+			static_assert(false == _has_static_listeners<TImplementor>::value, "StaticListeners are not published to concurrent readers");
+
+			const Epochs::Guard guard;
+			const typename ListenerRegistry<TImplementations, TEvent>::Snapshot * const snapshot = _registry.snapshot();
+			if ( nullptr == snapshot ) return;
+
+			for (const ::std::atomic<TListener *> & entry : snapshot->listeners)
+			{
+				TListener * const listener = entry.load();
+				if ( nullptr != listener ) function(listener);
+			}
+		}
+		else
+		{
+			_registry.for_each(function);
+		}
+	}
+
+	template<typename TFunction>
+	void for_each_listener(const TEvent & event, const TFunction & function) const
+	{
+		if constexpr ( _is_indexed<TImplementor>::value )
+		{
+			static_assert(false == _has_concurrent_hub<TImplementor>::value, "Subscriptions are not published to concurrent readers");
+			_registry.subscriptions().for_each_match(self()->event_key(event), function);
+		}
+		else
+		{
+			for_each_listener(function);
+		}
+	}
+
+	// Runs of events to the unsubscribed listeners, then all the events accepted by each
+	// subscriber in one call.
+	void deliver_subscribed(const TEvent * const * events, ::std::size_t count) const
+	{
+		const SubscriptionIndex<TImplementations, TEvent> & index = _registry.subscriptions();
+		const ::std::vector<TListener *> unsubscribed = index.unsubscribed();
+
+		for (TListener * listener : unsubscribed)
+		{
+			if ( index.contains(listener) ) deliver_batch(events, count, listener);
+		}
+
+		::std::vector<TListener *> matches;
+		::std::vector<TListener *> subscribers;
+		::std::unordered_map<TListener *, TBatches> accepted;
+
+		for (::std::size_t i = 0; i < count; ++i)
+		{
+			matches.clear();
+			index.collect(self()->event_key(*events[i]), matches);
+
+			for (TListener * listener : matches)
+			{
+				if ( false == self()->filter(*events[i], listener) ) continue;
+
+				TBatches & batch = accepted[listener];
+				if ( batch.empty() ) subscribers.push_back(listener);
+				batch.push_back(events[i]);
+			}
+		}
+
+		for (TListener * listener : subscribers)
+		{
+			const TBatches & batch = accepted[listener];
+			if ( index.contains(listener) ) listener->handle_events(batch.data(), batch.size());
+		}
+	}
+
+	eChange change_of(const TEvent & event) const
+	{
+		if constexpr ( _has_event_change<TImplementor>::value )
+		{
+			return self()->event_change(event);
+		}
+		else
+		{
+			return eChange::MODIFICATION;
+		}
+	}
+
+	// Disconnects the view of a listener too slow for the bus. Other listeners only lose
+	// the events they overflow with.
+	static void evict(TListener & listener)
+	{
+		View<TImplementations> * const view = dynamic_cast<View<TImplementations> *>(&listener);
+		if ( nullptr != view ) view->disconnect();
+	}
+
+	// Has the event_bus resolve the mailbox of listener before any event is posted to it.
+	void attach(TListener & listener) const
+	{
+		if constexpr ( _has_event_bus<TImplementor>::value )
+		{
+			static_cast<const typename TImplementor::event_bus &>(*self()).attach(&listener);
+		}
+	}
+
+	static void on_registry_removal(const void * emiter, TListener & listener)
+	{
+		static_cast<const typename TImplementor::event_bus &>(*static_cast<const Emiter *>(emiter)->self()).detach(&listener);
+	}
+
+	void deliver(const TEvent & event, TListener * listener) const
+	{
+		if (self()->filter(event, listener))
+		{
+			listener->handle_event(event);
+		}
+	}
+
+	void deliver_batch(const TEvent * const * events, ::std::size_t count, TListener * listener) const
+	{
+		::std::size_t run = 0;
+
+		for (::std::size_t i = 0; i < count; ++i)
+		{
+			if ( false == self()->filter(*events[i], listener) )
+			{
+				if ( run < i ) listener->handle_events(events + run, i - run);
+				run = i + 1;
+			}
+		}
+
+		if ( run < count ) listener->handle_events(events + run, count - run);
+	}
+
+	TImplementor * self() { return static_cast<TImplementor*>(this); }
+	const TImplementor * self() const { return static_cast<const TImplementor*>(this); }
+
+	ListenerRegistry<TImplementations, TEvent> _registry;
+};
+
+
+template<typename TImplementations, typename TEvent, typename... TEvents>
+class Emiter<TImplementations, TEvent, TEvents...>
+	: public Emiter<TImplementations, TEvent>
+	, public Emiter<TImplementations, TEvents...>
+{
+	typedef typename TImplementations::event_emiter TImplementor;
+	typedef Emiter<TImplementations, TEvent> TCurrent;
+	typedef Emiter<TImplementations, TEvents...> TNext;
+
+public:
+	template<typename TGeneric>
+	void propagate_generic_event(const TGeneric & generic) const
+	{
+		if constexpr ( false == _has_cast<TImplementor,TEvent,TGeneric>::value )
+		{
+			route_generic_event( generic );
+		}
+		else
+		{
+			TCurrent::propagate_generic_event( generic );
+			TNext::propagate_generic_event( generic );
+		}
+	}
+
+	template<typename TEventIterator>
+	void propagate_events(TEventIterator start, TEventIterator finish) const
+	{
+		while(start != finish) propagate_generic_event<>( **start++ );
+	}
+
+	// One lookup by dynamic type for all event types, none when TGeneric is not polymorphic.
+	template<typename TGeneric>
+	void route_generic_event(const TGeneric & generic) const
+	{
+		if constexpr ( ::std::is_polymorphic<TGeneric>::value )
+		{
+			route_at( reinterpret_cast<const char *>(&generic), EventRoutes<TGeneric,TEvent,TEvents...>::offsets(generic).data() );
+		}
+		else
+		{
+			TCurrent::route_generic_event( generic );
+			TNext::route_generic_event( generic );
+		}
+	}
+
+	template<typename TEventIterator>
+	void route_events(TEventIterator start, TEventIterator finish) const
+	{
+		while(start != finish) route_generic_event<>( **start++ );
+	}
+
+	// Partitions the generic events by event type, then propagates each type as one batch.
+	// Events of one type keep their order, but types are delivered one after the other.
+	template<typename TEventIterator>
+	void propagate_batch(TEventIterator start, TEventIterator finish) const
+	{
+		TBatches batches;
+		while(start != finish) collect( **start++, batches );
+		deliver_batches( batches );
+	}
+
+	template<typename TGeneric>
+	static constexpr bool can_register_listener(const Listener<TImplementations,TGeneric> & listener)
+	{
+		return TCurrent::template can_register_listener<TGeneric>(listener)
+			|| TNext::template can_register_listener<TGeneric>(listener);
+	}
+
+	template<typename TOther>
+	bool on_listener_registered(TOther & other)
+	{
+		typename TCurrent::TListener* const listener =
+			dynamic_cast<typename TCurrent::TListener*>(&other);
+		bool at_least_one = false;
+
+		if ( nullptr != listener )
+		{
+			at_least_one = true;
+			TCurrent::register_listener( *listener );
+		}
+
+		return at_least_one | TNext::on_listener_registered( other );
+	}
+
+	template<typename TOther>
+	bool on_listener_unregistered(TOther & other)
+	{
+		const bool current = TCurrent::on_listener_unregistered( other );
+		return TNext::on_listener_unregistered( other ) | current;
+	}
+
+	template<bool REGISTERED = true, typename TOther>
+	bool on_static_listener_registered(TOther & other)
+	{
+		const bool current = TCurrent::template on_static_listener_registered<REGISTERED>( other );
+		return TNext::template on_static_listener_registered<REGISTERED>( other ) | current;
+	}
+
+	template<typename TOther>
+	bool on_static_listener_unregistered(TOther & other)
+	{
+		const bool current = TCurrent::on_static_listener_unregistered( other );
+		return TNext::on_static_listener_unregistered( other ) | current;
+	}
+
+	template<typename TOther>
+	const ListenerRegistry<TImplementations, TOther> & registered_listeners() const
+	{
+		return static_cast<const Emiter<TImplementations, TOther> &>(*this).template registered_listeners<TOther>();
+	}
+
+	void deliver_pending() const
+	{
+		TCurrent::deliver_pending();
+		TNext::deliver_pending();
+	}
+
+	template<typename TOther>
+	void deliver_pending(TOther & other) const
+	{
+		TCurrent::deliver_pending( other );
+		TNext::deliver_pending( other );
+	}
+
+protected:
+	void route_at(const char * generic, const ::std::ptrdiff_t * offsets) const
+	{
+		TCurrent::route_at( generic, offsets );
+		TNext::route_at( generic, offsets + 1 );
+	}
+
+	typedef ::std::pair<typename TCurrent::TBatches, typename TNext::TBatches> TBatches;
+
+	template<typename TGeneric>
+	void collect(const TGeneric & generic, TBatches & batches) const
+	{
+		if constexpr ( ::std::is_polymorphic<TGeneric>::value )
+		{
+			collect_at( reinterpret_cast<const char *>(&generic), EventRoutes<TGeneric,TEvent,TEvents...>::offsets(generic).data(), batches );
+		}
+		else
+		{
+			TCurrent::collect( generic, batches.first );
+			TNext::collect( generic, batches.second );
+		}
+	}
+
+	void collect_at(const char * generic, const ::std::ptrdiff_t * offsets, TBatches & batches) const
+	{
+		TCurrent::collect_at( generic, offsets, batches.first );
+		TNext::collect_at( generic, offsets + 1, batches.second );
+	}
+
+	void deliver_batches(const TBatches & batches) const
+	{
+		TCurrent::deliver_batches( batches.first );
+		TNext::deliver_batches( batches.second );
+	}
+
+private:
+	TImplementor * self() { return static_cast<TImplementor*>(this); }
+	const TImplementor * self() const { return static_cast<const TImplementor*>(this); }
+};
+
+
+template<typename TImplementations, typename TEvent>
+class Listener<TImplementations, TEvent> : public Subscriber<TImplementations, TEvent>
+{
+	friend class ListenerRegistry<TImplementations, TEvent>;
+	friend class EventBus;
+	typedef typename TImplementations::template type_data<TEvent>::init_data TInitData;
+
+public:
+	Listener() : _registry(nullptr), _handle{0u, 0u} {}
+	Listener(const Listener &) : Listener() {}
+	Listener & operator=(const Listener &) { return *this; }
+	virtual ~Listener() { if ( nullptr != _registry ) _registry->remove(*this); }
+
+	virtual void handle_event(const TEvent & event) = 0;
+	virtual void initialize(TInitData && event) = 0;
+
+	// Runs of events from Emiter::propagate_batch, one handle_event each by default.
+	virtual void handle_events(const TEvent * const * events, ::std::size_t count)
+	{
+		for (::std::size_t i = 0; i < count; ++i) handle_event(*events[i]);
+	}
+
+private:
+	ListenerRegistry<TImplementations, TEvent> * _registry;
+	ListenerHandle _handle;
+	::std::shared_ptr<void> _mailbox;
+};
 
 
 template<typename TImplementations, typename TEvent, typename... TEvents>
@@ -309,10 +1756,20 @@ public:
 protected:
 	bool on_connection_attempt(Hub<TBridge> & c, TContext context, bool allowed)
 	{
-		return allowed && static_cast<TBridge&>(c).on_listener_registered(*self());
+		return allowed && register_to(static_cast<TBridge&>(c));
 	}
 
-	bool on_disconnection_attempt(Hub<TBridge> & , bool) const { return true; }
+	bool on_disconnection_attempt(Hub<TBridge> & c, bool allowed)
+	{
+		// Listeners already destroyed left their registries on their own, and cannot be
+		// reached from here anymore
+		if ( allowed ) unregister_from(static_cast<TBridge&>(c));
+		return true;
+	}
+
+	// Listeners are found by dynamic_cast, ListeningView knows them statically.
+	virtual bool register_to(TBridge & bridge) { return bridge.on_listener_registered(*self()); }
+	virtual bool unregister_from(TBridge & bridge) { return bridge.on_listener_unregistered(static_cast<View&>(*this)); }
 
 private:
 	TImplementor * self() { return static_cast<TImplementor*>(this); }
@@ -320,6 +1777,203 @@ private:
 };
 
 
+// View listening to a fixed set of events, registered to the bridge for the ones it emits
+// with static casts only.
+template<typename TImplementations, typename... TEvents>
+class ListeningView
+	: public TImplementations::view
+	, public Listener<TImplementations, TEvents...>
+{
+	typedef typename TImplementations::view_bridge TBridge;
+
+public:
+	typedef EventList<TEvents...> listened_events;
+
+protected:
+	bool register_to(TBridge & bridge) override { return bridge.on_static_listener_registered(*this); }
+	bool unregister_from(TBridge & bridge) override { return bridge.on_static_listener_unregistered(*this); }
+};
+
+
+// ListeningView known to the bridge by its concrete type TConcrete when the bridge holds it
+// in its StaticListeners, and registered like a ListeningView otherwise.
+template<typename TConcrete, typename TImplementations, typename... TEvents>
+class StaticListeningView : public ListeningView<TImplementations, TEvents...>
+{
+	template<typename, typename...> friend class StaticListeners;
+	typedef ListeningView<TImplementations, TEvents...> TListeningView;
+	typedef typename TImplementations::view_bridge TBridge;
+
+	static constexpr ::std::size_t kNOT_HELD = static_cast<::std::size_t>(-1);
+
+	template<typename TOther, typename = void>
+	struct _held_by : ::std::false_type {};
+
+	template<typename TOther>
+	struct _held_by<TOther, ::std::void_t<typename TOther::static_listeners>>
+		: ::std::bool_constant<TOther::static_listeners::template holds<TConcrete>()> {};
+
+public:
+	StaticListeningView() : _static_position(kNOT_HELD) {}
+	StaticListeningView(const StaticListeningView & other) : TListeningView(other), _static_position(kNOT_HELD) {}
+	StaticListeningView & operator=(const StaticListeningView &) { return *this; }
+
+	// Leaves the typed arrays while the concrete type can still be reached.
+	virtual ~StaticListeningView() { this->disconnect(); }
+
+protected:
+	bool register_to(TBridge & bridge) override
+	{
+		if constexpr ( _held_by<TBridge>::value )
+		{
+			if ( false == bridge.template on_static_listener_registered<false>(*this) ) return false;
+			static_cast<typename TBridge::static_listeners &>(bridge).add_static_listener(static_cast<TConcrete &>(*this));
+			return true;
+		}
+		else
+		{
+			return TListeningView::register_to(bridge);
+		}
+	}
+
+	bool unregister_from(TBridge & bridge) override
+	{
+		if constexpr ( _held_by<TBridge>::value )
+		{
+			if ( kNOT_HELD == _static_position ) return false;
+			static_cast<typename TBridge::static_listeners &>(bridge).template remove_static_listener<TConcrete>(_static_position);
+
+			if constexpr ( _has_event_bus<TBridge>::value )
+			{
+				const typename TBridge::event_bus & bus = bridge;
+				static_cast<void>( ( bus.detach(static_cast<Listener<TImplementations, TEvents> *>(this)), ... ) );
+			}
+
+			return true;
+		}
+		else
+		{
+			return TListeningView::unregister_from(bridge);
+		}
+	}
+
+private:
+	::std::size_t _static_position;
+};
+
+
+// Homogeneous arrays of the concrete listeners TConcretes, for bridges whose listener types
+// are known at compile time. Emiter::propagate_event reaches them after its registered
+// listeners with direct calls to TConcrete::handle_event, which the compiler can inline.
+// Listeners disconnected by a handler are skipped, the others all get the event.
+// Views other than these StaticListeningViews go through the registry as usual.
+template<typename TImplementations, typename... TConcretes>
+class StaticListeners
+{
+public:
+	typedef StaticListeners static_listeners;
+
+	StaticListeners() : _depth(0) {}
+
+	template<typename TConcrete>
+	static constexpr bool holds() { return ::std::disjunction<::std::is_same<TConcrete,TConcretes>...>::value; }
+
+	template<typename TConcrete>
+	const ::std::vector<TConcrete *> & typed_listeners() const { return ::std::get<::std::vector<TConcrete *>>(_arrays); }
+
+	template<typename TConcrete>
+	void add_static_listener(TConcrete & listener)
+	{
+		::std::vector<TConcrete *> & listeners = ::std::get<::std::vector<TConcrete *>>(_arrays);
+		listeners.push_back(&listener);
+		listener._static_position = listeners.size() - 1;
+	}
+
+	template<typename TConcrete>
+	void remove_static_listener(::std::size_t position)
+	{
+		::std::vector<TConcrete *> & listeners = ::std::get<::std::vector<TConcrete *>>(_arrays);
+		void * const removed = listeners[position];
+
+		for (::std::size_t depth = 0; depth < _depth; ++depth) ::std::replace(_walks[depth].begin(), _walks[depth].end(), removed, static_cast<void *>(nullptr));
+
+		listeners[position]->_static_position = TConcrete::kNOT_HELD;
+		listeners[position] = listeners.back();
+		listeners[position]->_static_position = position;
+		listeners.pop_back();
+	}
+
+	template<typename TEvent, typename TFilter>
+	void dispatch_static(const TEvent & event, const TFilter & filter) const
+	{
+		static_cast<void>( ( dispatch_array(event, ::std::get<::std::vector<TConcretes *>>(_arrays), filter), ... ) );
+	}
+
+	template<typename TEvent, typename TFunction>
+	void for_each_static(const TFunction & function) const
+	{
+		static_cast<void>( ( for_each_in<TEvent>(::std::get<::std::vector<TConcretes *>>(_arrays), function), ... ) );
+	}
+
+private:
+	template<typename TEvent, typename TConcrete, typename TFunction>
+	bool for_each_in(const ::std::vector<TConcrete *> & listeners, const TFunction & function) const
+	{
+		if constexpr ( ::std::is_base_of<Listener<TImplementations, TEvent>, TConcrete>::value )
+		{
+			walk(listeners, function);
+		}
+
+		return true;
+	}
+
+	template<typename TEvent, typename TConcrete, typename TFilter>
+	bool dispatch_array(const TEvent & event, const ::std::vector<TConcrete *> & listeners, const TFilter & filter) const
+	{
+		if constexpr ( ::std::is_base_of<Listener<TImplementations, TEvent>, TConcrete>::value )
+		{
+			walk(listeners, [&event, &filter](TConcrete * listener)
+			{
+				if ( filter(event, listener) ) listener->TConcrete::handle_event(event);
+			});
+		}
+
+		return true;
+	}
+
+	// Calls function(TConcrete *) on the listeners as they were on the call. They are copied
+	// in a buffer kept per nesting level, where removals null them, so handlers may
+	// disconnect views or propagate in turn.
+	template<typename TConcrete, typename TFunction>
+	void walk(const ::std::vector<TConcrete *> & listeners, const TFunction & function) const
+	{
+		if ( _walks.size() == _depth ) _walks.emplace_back();
+		::std::vector<void *> & walk = _walks[_depth++];
+
+		walk.assign(listeners.begin(), listeners.end());
+
+		try
+		{
+			for (::std::size_t i = 0; i < walk.size(); ++i)
+			{
+				if ( nullptr != walk[i] ) function(static_cast<TConcrete *>(walk[i]));
+			}
+		}
+		catch (...)
+		{
+			--_depth;
+			throw;
+		}
+
+		--_depth;
+	}
+
+	::std::tuple<::std::vector<TConcretes *>...> _arrays;
+	mutable ::std::deque<::std::vector<void *>> _walks;
+	mutable ::std::size_t _depth;
+};
+
+
 enum class eInputStatus
 {
 		REJECTED
@@ -328,6 +1982,15 @@ enum class eInputStatus
 };
 
 
+// Thrown by Inputer::send_input() and async_send() while an input sent with async_send()
+// has no outcome yet.
+struct EInputPending {};
+
+// Thrown by InputBridge::on_reply() when the input was sent with Inputer::async_send() and
+// its outcome was already given: such inputs get their reply before being accepted.
+struct ELateReply {};
+
+
 template<typename TImplementations>
 class InputBridge : public Hub<typename TImplementations::input_bridge>
 {
@@ -339,9 +2002,104 @@ class InputBridge : public Hub<typename TImplementations::input_bridge>
 protected:
 	virtual eInputStatus handle_input(TInputer & inputer, TMessage && message) = 0;
 
-	void on_reply(TInputer & inputer, TReply && reply) { inputer.reply_cb(std::move(reply)); }
-	void on_async_accepted(TInputer & inputer) { inputer.accepted_cb(); }
-	void on_async_rejected(TInputer & inputer) { inputer.rejected_cb(); }
+	void on_reply(TInputer & inputer, TReply && reply) { inputer.receive_reply(std::move(reply)); }
+	void on_async_accepted(TInputer & inputer) { inputer.complete(eInputStatus::ACCEPTED); }
+	void on_async_rejected(TInputer & inputer) { inputer.complete(eInputStatus::REJECTED); }
+};
+
+
+// Outcome of an input sent with Inputer::async_send(), with the reply the bridge gave if any.
+template<typename TImplementations>
+struct InputOutcome
+{
+	eInputStatus status;
+	::std::optional<typename TImplementations::reply> reply;
+};
+
+
+// Handle on the outcome of Inputer::async_send(), which is kept in the inputer itself. The
+// outcome goes to a continuation given to then(), or to the coroutine awaiting the future,
+// called right from the bridge. Dropping the future before the outcome hands it to the
+// callbacks of the inputer, an outcome already there is discarded.
+template<typename TImplementations>
+class InputFuture
+{
+	friend class Inputer<TImplementations>;
+	typedef Inputer<TImplementations> TInputer;
+	typedef InputOutcome<TImplementations> TOutcome;
+
+public:
+	InputFuture(InputFuture && other) : _inputer(other._inputer) { other._inputer = nullptr; }
+	InputFuture(const InputFuture &) = delete;
+	InputFuture & operator=(const InputFuture &) = delete;
+	InputFuture & operator=(InputFuture &&) = delete;
+
+	~InputFuture() { if ( nullptr != _inputer ) _inputer->release(); }
+
+	bool valid() const { return nullptr != _inputer; }
+	bool ready() const { return nullptr != _inputer && _inputer->ready(); }
+
+	// Calls function(InputOutcome &&) once with the outcome: right away if it is there, from
+	// the bridge otherwise. Function is kept by reference until then, and the future is done.
+	template<typename TFunction>
+	void then(TFunction & function)
+	{
+		TInputer * inputer = _inputer;
+		_inputer = nullptr;
+
+		if ( false == inputer->attach(&InputFuture::resume<TFunction>, &function) ) function(inputer->take());
+	}
+
+	template<typename TFunction>
+	void then(const TFunction &&) = delete;
+
+#if defined(__cpp_impl_coroutine)
+	class Awaiter
+	{
+	public:
+		explicit Awaiter(TInputer * inputer) : _inputer(inputer) {}
+		Awaiter(const Awaiter &) = delete;
+		Awaiter & operator=(const Awaiter &) = delete;
+
+		~Awaiter() { if ( nullptr != _inputer ) _inputer->release(); }
+
+		bool await_ready() const { return _inputer->ready(); }
+
+		bool await_suspend(::std::coroutine_handle<> handle)
+		{
+			_handle = handle;
+			return _inputer->attach(&Awaiter::resume, this);
+		}
+
+		TOutcome await_resume()
+		{
+			TInputer * inputer = _inputer;
+			_inputer = nullptr;
+			return inputer->take();
+		}
+
+	private:
+		static void resume(void * context, TInputer &) { static_cast<Awaiter *>(context)->_handle.resume(); }
+
+		TInputer * _inputer;
+		::std::coroutine_handle<> _handle;
+	};
+
+	Awaiter operator co_await() &&
+	{
+		TInputer * inputer = _inputer;
+		_inputer = nullptr;
+		return Awaiter(inputer);
+	}
+#endif
+
+private:
+	explicit InputFuture(TInputer & inputer) : _inputer(&inputer) {}
+
+	template<typename TFunction>
+	static void resume(void * context, TInputer & inputer) { (*static_cast<TFunction *>(context))(inputer.take()); }
+
+	TInputer * _inputer;
 };
 
 
@@ -362,6 +2120,12 @@ public:
 
 	eInputStatus send_input(TMessage && message)
 	{
+		{
+			::std::lock_guard<::std::mutex> lock(_pending.mutex);
+			if ( eAwait::AWAITED == _pending.await ) throw EInputPending();
+			_pending.await = eAwait::NONE;
+		}
+
 		eInputStatus status;
 
 		if ( spoke::is_connected() )
@@ -390,6 +2154,39 @@ public:
 		return status;
 	}
 
+	// Same as send_input(), but the outcome and the reply go to the returned future instead
+	// of the callbacks. The bridge must reply before accepting. An inputer has one such input
+	// pending at a time, it must stay connected and alive until the outcome is given.
+	InputFuture<TImplementations> async_send(TMessage && message)
+	{
+		{
+			::std::lock_guard<::std::mutex> lock(_pending.mutex);
+			if ( eAwait::AWAITED == _pending.await ) throw EInputPending();
+
+			_pending.await = eAwait::AWAITED;
+			_pending.status = eInputStatus::DELAYED;
+			_pending.reply.reset();
+			_pending.resume = nullptr;
+		}
+
+		eInputStatus status = eInputStatus::REJECTED;
+
+		try
+		{
+			if ( spoke::is_connected() ) status = bridge()->handle_input(static_cast<TInputer&>(*this), std::move(message));
+		}
+		catch (...)
+		{
+			::std::lock_guard<::std::mutex> lock(_pending.mutex);
+			_pending.await = eAwait::NONE;
+			throw;
+		}
+
+		if ( eInputStatus::DELAYED != status ) complete(status);
+
+		return InputFuture<TImplementations>(*this);
+	}
+
 	void disconnect() { Spoke<typename TImplementations::inputer>::template disconnect<TBridge>(); }
 
 	TBridge * bridge() const { return static_cast<TBridge*>(this->hub()); }
@@ -401,9 +2198,129 @@ protected:
 
 	bool on_connection_attempt(Hub<TBridge> & , TContext , bool ) const { return true; }
 	bool on_disconnection_attempt(Hub<TBridge> & , bool ) const { return true; }
+
+private:
+	friend class InputFuture<TImplementations>;
+	typedef void (*TResume)(void * context, Inputer & inputer);
+
+	enum class eAwait
+	{
+			NONE
+		,	AWAITED
+		,	GIVEN
+	};
+
+	// Outcome of the last input sent with async_send(), until it is given to the future.
+	struct Pending
+	{
+		Pending() : await(eAwait::NONE), status(eInputStatus::DELAYED), resume(nullptr), context(nullptr) {}
+
+		::std::mutex mutex;
+		eAwait await;
+		eInputStatus status;
+		::std::optional<TReply> reply;
+		TResume resume;
+		void * context;
+	};
+
+	void receive_reply(TReply && reply)
+	{
+		{
+			::std::lock_guard<::std::mutex> lock(_pending.mutex);
+
+			if ( eAwait::AWAITED == _pending.await && eInputStatus::DELAYED == _pending.status )
+			{
+				_pending.reply.emplace(std::move(reply));
+				return;
+			}
+
+			if ( eAwait::NONE != _pending.await ) throw ELateReply();
+		}
+
+		reply_cb(std::move(reply));
+	}
+
+	void complete(eInputStatus status)
+	{
+		{
+			::std::unique_lock<::std::mutex> lock(_pending.mutex);
+
+			if ( eAwait::AWAITED == _pending.await )
+			{
+				if ( eInputStatus::DELAYED != _pending.status ) return;
+
+				_pending.status = status;
+				if ( nullptr == _pending.resume ) return;
+
+				const TResume resume = _pending.resume;
+				void * const context = _pending.context;
+				_pending.resume = nullptr;
+
+				lock.unlock();
+				resume(context, *this);
+				return;
+			}
+		}
+
+		if ( eInputStatus::ACCEPTED == status )
+			accepted_cb();
+		else
+			rejected_cb();
+	}
+
+	bool ready()
+	{
+		::std::lock_guard<::std::mutex> lock(_pending.mutex);
+		return eInputStatus::DELAYED != _pending.status;
+	}
+
+	// False when the outcome is already there, for take(). Otherwise resume(context, *this)
+	// is called once it is, and has to take() it.
+	bool attach(TResume resume, void * context)
+	{
+		::std::lock_guard<::std::mutex> lock(_pending.mutex);
+		if ( eInputStatus::DELAYED != _pending.status ) return false;
+
+		_pending.resume = resume;
+		_pending.context = context;
+		return true;
+	}
+
+	InputOutcome<TImplementations> take()
+	{
+		::std::lock_guard<::std::mutex> lock(_pending.mutex);
+
+		InputOutcome<TImplementations> outcome{_pending.status, ::std::move(_pending.reply)};
+		_pending.await = eAwait::GIVEN;
+		_pending.reply.reset();
+		return outcome;
+	}
+
+	void release()
+	{
+		::std::lock_guard<::std::mutex> lock(_pending.mutex);
+
+		_pending.await = eInputStatus::DELAYED == _pending.status ? eAwait::NONE : eAwait::GIVEN;
+		_pending.reply.reset();
+		_pending.resume = nullptr;
+	}
+
+	Pending _pending;
 };
 
 
+// Inputer only used through async_send(), which needs none of the callbacks.
+template<typename TImplementations>
+class AsyncInputer : public Inputer<TImplementations>
+{
+	typedef typename TImplementations::reply TReply;
+
+protected:
+	void accepted_cb() override {}
+	void rejected_cb() override {}
+	void reply_cb(TReply && ) override {}
+};
+
 }
 }
 
@@ -0,0 +1,402 @@
+#ifndef MVC_ASYNC_HXX
+#define MVC_ASYNC_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "apophenic/MVC.hxx"
+
+
+namespace ap
+{
+namespace mvc
+{
+
+
+// What a full mailbox does with the next event posted to it. BLOCK waits for room, unless
+// posted from the handler of that mailbox. DISCONNECT drops it and has the Emiter
+// disconnect the view once the event is posted to the others.
+enum class eOverflow
+{
+		BLOCK
+	,	DROP_OLDEST
+	,	DROP_NEWEST
+	,	DISCONNECT
+};
+
+
+struct QueueStats
+{
+	::std::size_t depth;
+	::std::size_t high_water;
+	::std::size_t dropped;
+};
+
+
+// Asynchronous delivery for an Emiter, enabled by deriving the bridge from it. Every
+// propagated event is copied once into a shared payload, and posted to the mailbox of each
+// accepting listener object. Workers run one mailbox at a time, so each view receives its
+// events in order and never concurrently, whatever their types.
+// Disconnection drops the pending events of the view and waits for the one being handled,
+// so none is delivered once View::disconnect() returns. Views must disconnect before their
+// destruction starts, their handlers may be running on a worker until then. Handlers must
+// not throw.
+// Mailboxes hold at most a capacity of events, given for all of them on construction or
+// for a view by bound(), which lasts until the view disconnects.
+// The Emiter has the mailbox of a listener resolved when registering it, and kept by the
+// listener, so posting to it takes no lock of the bus. Others are looked up on each post.
+class EventBus
+{
+	struct Delivery
+	{
+		void (*call)(void * listener, const void * event);
+		void * listener;
+		::std::shared_ptr<const void> event;
+	};
+
+	struct Mailbox
+	{
+		Mailbox(const void * object, ::std::size_t capacity, eOverflow overflow)
+			: object(object), capacity(capacity), overflow(overflow), high_water(0), dropped(0), scheduled(false), closed(false) {}
+
+		const void * const object;
+		::std::vector<const void *> listeners;
+
+		::std::mutex mutex;
+		::std::condition_variable idle;
+		::std::condition_variable room;
+		::std::deque<Delivery> queue;
+		::std::size_t capacity;
+		eOverflow overflow;
+		::std::size_t high_water;
+		::std::size_t dropped;
+		::std::thread::id running;
+		bool scheduled;
+		bool closed;
+	};
+
+	struct State
+	{
+		State(::std::size_t capacity, eOverflow overflow) : capacity(capacity), overflow(overflow), pending(0), stop(false) {}
+
+		::std::shared_ptr<Mailbox> & mailbox(const void * listener, const void * object)
+		{
+			::std::shared_ptr<Mailbox> & found = by_listener[listener];
+
+			if ( nullptr == found )
+			{
+				::std::shared_ptr<Mailbox> & shared = by_object[object];
+				if ( nullptr == shared ) shared = ::std::make_shared<Mailbox>(object, capacity, overflow);
+				shared->listeners.push_back(listener);
+				found = shared;
+			}
+
+			return found;
+		}
+
+		const ::std::size_t capacity;
+		const eOverflow overflow;
+
+		::std::mutex mutex;
+		::std::condition_variable ready_cv;
+		::std::condition_variable idle_cv;
+		::std::deque<::std::shared_ptr<Mailbox>> ready;
+		::std::unordered_map<const void *, ::std::shared_ptr<Mailbox>> by_listener;
+		::std::unordered_map<const void *, ::std::shared_ptr<Mailbox>> by_object;
+		::std::atomic<::std::size_t> pending;
+		bool stop;
+	};
+
+	// Deliveries a worker runs from one mailbox before giving others their turn.
+	static constexpr unsigned kBURST = 64;
+
+public:
+	typedef EventBus event_bus;
+
+	static constexpr ::std::size_t kUNBOUNDED = static_cast<::std::size_t>(-1);
+
+	explicit EventBus(
+			unsigned nb_threads = ::std::thread::hardware_concurrency()
+		,	::std::size_t capacity = kUNBOUNDED
+		,	eOverflow overflow = eOverflow::BLOCK
+		)
+		: _state(new State(0 == capacity ? 1 : capacity, overflow))
+	{
+		if ( 0 == nb_threads ) nb_threads = 1;
+		for (unsigned i = 0; i < nb_threads; ++i) _workers.emplace_back(&EventBus::work, _state.get());
+	}
+
+	EventBus(const EventBus &) = delete;
+	EventBus & operator=(const EventBus &) = delete;
+
+	// Pending events are dropped, the ones being handled are finished.
+	~EventBus()
+	{
+		{
+			::std::lock_guard<::std::mutex> lock(_state->mutex);
+			_state->stop = true;
+		}
+
+		_state->ready_cv.notify_all();
+		for (::std::thread & worker : _workers) worker.join();
+	}
+
+	// Resolves the mailbox of the object of listener, which listener keeps for post().
+	template<typename TListener>
+	void attach(TListener * listener) const
+	{
+		::std::lock_guard<::std::mutex> lock(_state->mutex);
+		listener->_mailbox = _state->mailbox(listener, dynamic_cast<const void *>(listener));
+	}
+
+	// False when the listener overflowed its mailbox with eOverflow::DISCONNECT.
+	template<typename TListener, typename TEvent>
+	bool post(TListener * listener, ::std::shared_ptr<const TEvent> event) const
+	{
+		State & state = *_state;
+		::std::shared_ptr<Mailbox> resolved;
+
+		if ( nullptr == listener->_mailbox )
+		{
+			::std::lock_guard<::std::mutex> lock(state.mutex);
+			resolved = state.mailbox(listener, dynamic_cast<const void *>(listener));
+		}
+
+		Mailbox * const mailbox = nullptr == resolved ? static_cast<Mailbox *>(listener->_mailbox.get()) : resolved.get();
+		state.pending.fetch_add(1);
+
+		bool schedule;
+
+		{
+			::std::unique_lock<::std::mutex> lock(mailbox->mutex);
+
+			if (	mailbox->capacity <= mailbox->queue.size()
+				&&	eOverflow::BLOCK == mailbox->overflow
+				&&	::std::this_thread::get_id() != mailbox->running
+				)
+			{
+				mailbox->room.wait(lock, [mailbox]() { return mailbox->closed || mailbox->queue.size() < mailbox->capacity; });
+			}
+
+			::std::size_t dropped = 0;
+
+			if ( mailbox->closed )
+			{
+				dropped = 1;
+			}
+			else if ( mailbox->capacity <= mailbox->queue.size() && eOverflow::BLOCK != mailbox->overflow )
+			{
+				++mailbox->dropped;
+				dropped = 1;
+
+				if ( eOverflow::DROP_OLDEST == mailbox->overflow )
+				{
+					mailbox->queue.pop_front();
+					mailbox->queue.push_back(Delivery{&EventBus::call<TListener,TEvent>, listener, ::std::move(event)});
+				}
+			}
+			else
+			{
+				mailbox->queue.push_back(Delivery{&EventBus::call<TListener,TEvent>, listener, ::std::move(event)});
+				if ( mailbox->high_water < mailbox->queue.size() ) mailbox->high_water = mailbox->queue.size();
+			}
+
+			if ( 0 != dropped )
+			{
+				const bool evict = false == mailbox->closed && eOverflow::DISCONNECT == mailbox->overflow;
+				lock.unlock();
+				done(state, dropped);
+				return false == evict;
+			}
+
+			schedule = false == mailbox->scheduled;
+			mailbox->scheduled = true;
+		}
+
+		if ( schedule )
+		{
+			if ( nullptr == resolved ) resolved = ::std::static_pointer_cast<Mailbox>(listener->_mailbox);
+
+			{
+				::std::lock_guard<::std::mutex> lock(state.mutex);
+				state.ready.push_back(::std::move(resolved));
+			}
+
+			state.ready_cv.notify_one();
+		}
+
+		return true;
+	}
+
+	// Capacity and overflow of the mailbox of the object of listener.
+	template<typename TListener>
+	void bound(TListener * listener, ::std::size_t capacity, eOverflow overflow) const
+	{
+		::std::shared_ptr<Mailbox> mailbox;
+
+		{
+			::std::lock_guard<::std::mutex> lock(_state->mutex);
+			mailbox = _state->mailbox(listener, dynamic_cast<const void *>(listener));
+		}
+
+		::std::lock_guard<::std::mutex> lock(mailbox->mutex);
+		mailbox->capacity = 0 == capacity ? 1 : capacity;
+		mailbox->overflow = overflow;
+		mailbox->room.notify_all();
+	}
+
+	// Counters of the mailbox of the object of listener, all nil without one.
+	template<typename TListener>
+	QueueStats stats(const TListener * listener) const
+	{
+		::std::shared_ptr<Mailbox> mailbox;
+
+		{
+			::std::lock_guard<::std::mutex> lock(_state->mutex);
+			auto found = _state->by_object.find(dynamic_cast<const void *>(listener));
+			if ( _state->by_object.end() == found ) return QueueStats{0, 0, 0};
+			mailbox = found->second;
+		}
+
+		::std::lock_guard<::std::mutex> lock(mailbox->mutex);
+		return QueueStats{mailbox->queue.size(), mailbox->high_water, mailbox->dropped};
+	}
+
+	// Drops what is pending for the object of listener and waits for the event it is
+	// handling, unless called from that handler.
+	void detach(const void * listener) const
+	{
+		State & state = *_state;
+		::std::shared_ptr<Mailbox> mailbox;
+
+		{
+			::std::lock_guard<::std::mutex> lock(state.mutex);
+			auto found = state.by_listener.find(listener);
+			if ( state.by_listener.end() == found ) return;
+
+			mailbox = found->second;
+			for (const void * other : mailbox->listeners) state.by_listener.erase(other);
+			state.by_object.erase(mailbox->object);
+		}
+
+		::std::size_t dropped;
+
+		{
+			::std::unique_lock<::std::mutex> lock(mailbox->mutex);
+			mailbox->closed = true;
+			dropped = mailbox->queue.size();
+			mailbox->queue.clear();
+			mailbox->room.notify_all();
+
+			mailbox->idle.wait(lock, [&mailbox]()
+			{
+				return	::std::thread::id() == mailbox->running
+					||	::std::this_thread::get_id() == mailbox->running;
+			});
+		}
+
+		done(state, dropped);
+	}
+
+	// Blocks until every posted event was delivered or dropped.
+	void wait_idle() const
+	{
+		::std::unique_lock<::std::mutex> lock(_state->mutex);
+		_state->idle_cv.wait(lock, [this]() { return 0 == _state->pending.load(); });
+	}
+
+	::std::size_t nb_threads() const { return _workers.size(); }
+
+private:
+	template<typename TListener, typename TEvent>
+	static void call(void * listener, const void * event)
+	{
+		static_cast<TListener *>(listener)->handle_event(*static_cast<const TEvent *>(event));
+	}
+
+	static void done(State & state, ::std::size_t count)
+	{
+		if ( 0 == count || count != state.pending.fetch_sub(count) ) return;
+
+		// Taken so that wait_idle either sees no pending event or is already waiting.
+		{
+			const ::std::lock_guard<::std::mutex> lock(state.mutex);
+		}
+
+		state.idle_cv.notify_all();
+	}
+
+	static void work(State * state)
+	{
+		for (;;)
+		{
+			::std::shared_ptr<Mailbox> mailbox;
+
+			{
+				::std::unique_lock<::std::mutex> lock(state->mutex);
+				state->ready_cv.wait(lock, [state]() { return state->stop || false == state->ready.empty(); });
+				if ( state->stop ) return;
+
+				mailbox = ::std::move(state->ready.front());
+				state->ready.pop_front();
+			}
+
+			run(*state, ::std::move(mailbox));
+		}
+	}
+
+	static void run(State & state, ::std::shared_ptr<Mailbox> && mailbox)
+	{
+		for (unsigned burst = 0; ; ++burst)
+		{
+			Delivery delivery;
+
+			{
+				::std::lock_guard<::std::mutex> lock(mailbox->mutex);
+				mailbox->running = ::std::thread::id();
+				mailbox->idle.notify_all();
+
+				if ( mailbox->closed || mailbox->queue.empty() )
+				{
+					mailbox->scheduled = false;
+					return;
+				}
+
+				if ( kBURST == burst ) break;
+
+				delivery = ::std::move(mailbox->queue.front());
+				mailbox->queue.pop_front();
+				mailbox->running = ::std::this_thread::get_id();
+				mailbox->room.notify_one();
+			}
+
+			delivery.call(delivery.listener, delivery.event.get());
+			done(state, 1);
+		}
+
+		// Still scheduled, back in line behind the other mailboxes
+		{
+			::std::lock_guard<::std::mutex> lock(state.mutex);
+			state.ready.push_back(::std::move(mailbox));
+		}
+
+		state.ready_cv.notify_one();
+	}
+
+	::std::unique_ptr<State> _state;
+	::std::vector<::std::thread> _workers;
+};
+
+
+}
+}
+
+#endif // MVC_ASYNC_HXX
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#if defined( __linux__ )
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+#if defined( _MSC_VER )
+#define BENCH_NOINLINE __declspec( noinline )
+#else
+#define BENCH_NOINLINE __attribute__( ( noinline ) )
+#endif
+
+
+namespace bench
+{
+
+
+// Keeps the optimizer from discarding a benchmarked value.
+template< typename T >
+inline void keep( T const & value )
+{
+#if defined( _MSC_VER )
+	static void const * volatile sink;
+	sink = &value;
+#else
+	asm volatile( "" : : "r,m"( value ) : "memory" );
+#endif
+}
+
+
+// Returns value through an opaque register, so that the optimizer cannot fold it.
+template< typename T >
+inline T hide( T value )
+{
+#if ! defined( _MSC_VER )
+	asm volatile( "" : "+r"( value ) );
+#endif
+	return value;
+}
+
+
+// User-space retired instructions of the calling thread, where the platform exposes them.
+class InstructionCounter
+{
+public:
+	InstructionCounter() : _fd( -1 )
+	{
+#if defined( __linux__ )
+		perf_event_attr attributes;
+		::std::memset( &attributes, 0, sizeof( attributes ) );
+		attributes.type = PERF_TYPE_HARDWARE;
+		attributes.size = sizeof( attributes );
+		attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+		attributes.disabled = 1;
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		_fd = static_cast< int >( syscall( __NR_perf_event_open, &attributes, 0, -1, -1, 0 ) );
+#endif
+	}
+
+	~InstructionCounter()
+	{
+#if defined( __linux__ )
+		if ( _fd >= 0 ) close( _fd );
+#endif
+	}
+
+	bool available() const { return _fd >= 0; }
+
+	void start()
+	{
+#if defined( __linux__ )
+		if ( _fd < 0 ) return;
+		ioctl( _fd, PERF_EVENT_IOC_RESET, 0 );
+		ioctl( _fd, PERF_EVENT_IOC_ENABLE, 0 );
+#endif
+	}
+
+	::std::uint64_t stop()
+	{
+		::std::uint64_t count = 0;
+#if defined( __linux__ )
+		if ( _fd < 0 ) return 0;
+		ioctl( _fd, PERF_EVENT_IOC_DISABLE, 0 );
+		if ( sizeof( count ) != read( _fd, &count, sizeof( count ) ) ) count = 0;
+#endif
+		return count;
+	}
+
+private:
+	int _fd;
+};
+
+
+struct Measure
+{
+	double ns;
+	double instructions;
+};
+
+
+// Mean cost per call of function( i ) for i in [0, iterations), in time and, when hardware
+// counters are readable, in instructions. Kept out of line, so that each loop gets its own
+// registers rather than those left over by the caller.
+template< typename Function >
+BENCH_NOINLINE Measure measure( unsigned long iterations, Function && function )
+{
+	static InstructionCounter counter;
+
+	for ( unsigned long i = 0; i < iterations / 10; ++i ) function( i );
+
+	counter.start();
+	auto const start = ::std::chrono::steady_clock::now();
+	for ( unsigned long i = 0; i < iterations; ++i ) function( i );
+	auto const finish = ::std::chrono::steady_clock::now();
+	::std::uint64_t const instructions = counter.stop();
+
+	return Measure{ ::std::chrono::duration< double, ::std::nano >( finish - start ).count() / iterations, double( instructions ) / iterations };
+}
+
+
+inline void report( char const * label, Measure const & cost )
+{
+	if ( cost.instructions > 0 ) ::std::printf( "%-48s %10.2f ns/op %10.1f instr/op\n", label, cost.ns, cost.instructions );
+	else ::std::printf( "%-48s %10.2f ns/op\n", label, cost.ns );
+}
+
+
+// Measures function and prints its cost.
+template< typename Function >
+double run( char const * label, unsigned long iterations, Function && function )
+{
+	Measure const cost = measure( iterations, function );
+	report( label, cost );
+	return cost.ns;
+}
+
+
+// Measures a reference and a candidate over several rounds, each going first in turn, and
+// prints the best round of each, so that frequency ramps and noisy neighbours hit both alike.
+template< typename Reference, typename Candidate >
+void versus( char const * reference_label, char const * candidate_label, unsigned rounds, unsigned long iterations, Reference && reference, Candidate && candidate )
+{
+	Measure best_reference{ 0, 0 };
+	Measure best_candidate{ 0, 0 };
+
+	for ( unsigned round = 0; round < rounds; ++round )
+	{
+		Measure candidate_cost;
+		Measure reference_cost;
+
+		if ( round & 1 )
+		{
+			candidate_cost = measure( iterations, candidate );
+			reference_cost = measure( iterations, reference );
+		}
+		else
+		{
+			reference_cost = measure( iterations, reference );
+			candidate_cost = measure( iterations, candidate );
+		}
+
+		if ( 0 == round || reference_cost.ns < best_reference.ns ) best_reference = reference_cost;
+		if ( 0 == round || candidate_cost.ns < best_candidate.ns ) best_candidate = candidate_cost;
+	}
+
+	report( reference_label, best_reference );
+	report( candidate_label, best_candidate );
+}
+
+}
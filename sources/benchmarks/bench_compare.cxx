@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "apophenic/Introspect.hxx"
+#include "apophenic/IntrospectCompare.hxx"
+
+#include "benchmarks/bench.hxx"
+
+
+struct QuoteBase
+{
+	std::uint64_t instrument;
+	std::uint32_t venue;
+	std::int32_t level;
+	std::int64_t price;
+	std::int64_t quantity;
+	std::string trader;
+};
+
+
+class Quote
+	: public QuoteBase
+	, public ::ap::insp::Introspector<
+			Quote
+		,	::ap::insp::Member< &QuoteBase::instrument >
+		,	::ap::insp::Member< &QuoteBase::venue >
+		,	::ap::insp::Member< &QuoteBase::level >
+		,	::ap::insp::Member< &QuoteBase::price >
+		,	::ap::insp::Member< &QuoteBase::quantity >
+		,	::ap::insp::Member< &QuoteBase::trader >
+		>
+{
+public:
+	Quote(std::uint64_t i, std::uint32_t v, std::int32_t l, std::int64_t p, std::int64_t q, std::string t)
+		: QuoteBase{ i, v, l, p, q, t } {}
+};
+
+
+namespace ap
+{
+namespace insp
+{
+
+template<> const char * const Member< &QuoteBase::instrument >::kNAME = "instrument";
+template<> const char * const Member< &QuoteBase::venue >::kNAME = "venue";
+template<> const char * const Member< &QuoteBase::level >::kNAME = "level";
+template<> const char * const Member< &QuoteBase::price >::kNAME = "price";
+template<> const char * const Member< &QuoteBase::quantity >::kNAME = "quantity";
+template<> const char * const Member< &QuoteBase::trader >::kNAME = "trader";
+
+}
+}
+
+
+struct HandWrittenHash
+{
+	std::size_t operator()(Quote const & q) const
+	{
+		std::size_t seed = 0;
+		auto combine = [&seed](std::size_t h) { seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2); };
+		combine(std::hash<std::uint64_t>()(q.instrument));
+		combine(std::hash<std::uint32_t>()(q.venue));
+		combine(std::hash<std::int32_t>()(q.level));
+		combine(std::hash<std::int64_t>()(q.price));
+		combine(std::hash<std::int64_t>()(q.quantity));
+		combine(std::hash<std::string>()(q.trader));
+		return seed;
+	}
+};
+
+
+struct HandWrittenEqual
+{
+	bool operator()(Quote const & a, Quote const & b) const
+	{
+		return a.instrument == b.instrument
+			&& a.venue == b.venue
+			&& a.level == b.level
+			&& a.price == b.price
+			&& a.quantity == b.quantity
+			&& a.trader == b.trader;
+	}
+};
+
+
+struct HandWrittenLess
+{
+	bool operator()(Quote const & a, Quote const & b) const
+	{
+		return std::tie(a.instrument, a.venue, a.level, a.price, a.quantity, a.trader)
+			< std::tie(b.instrument, b.venue, b.level, b.price, b.quantity, b.trader);
+	}
+};
+
+
+int main()
+{
+	constexpr unsigned long kRECORDS = 4096;
+	constexpr unsigned long kITERATIONS = 5000000;
+	constexpr unsigned kROUNDS = 8;
+
+	std::vector<Quote> quotes;
+	for (unsigned long i = 0; i < kRECORDS; ++i)
+	{
+		quotes.emplace_back(i / 4, 7, i % 4, 100000 + i, 10, "trader");
+	}
+
+	std::vector<Quote> copies(quotes);
+	auto const mask = kRECORDS - 1;
+
+	bench::versus("hash hand-written", "hash ap::insp::Hash", kROUNDS, kITERATIONS
+		, [&](unsigned long i) { bench::keep(HandWrittenHash()(quotes[i & mask])); }
+		, [&](unsigned long i) { bench::keep(::ap::insp::Hash<Quote>()(quotes[i & mask])); }
+		);
+
+	bench::versus("equal hand-written", "equal ap::insp::EqualTo", kROUNDS, kITERATIONS
+		, [&](unsigned long i) { bench::keep(HandWrittenEqual()(quotes[i & mask], copies[i & mask])); }
+		, [&](unsigned long i) { bench::keep(::ap::insp::EqualTo<Quote>()(quotes[i & mask], copies[i & mask])); }
+		);
+
+	bench::versus("less hand-written", "less ap::insp::Less", kROUNDS, kITERATIONS
+		, [&](unsigned long i) { bench::keep(HandWrittenLess()(quotes[i & mask], copies[(i + 1) & mask])); }
+		, [&](unsigned long i) { bench::keep(::ap::insp::Less<Quote>()(quotes[i & mask], copies[(i + 1) & mask])); }
+		);
+
+	return 0;
+}
@@ -0,0 +1,136 @@
+#include <cstdio>
+#include <string>
+
+#include "apophenic/Introspect.hxx"
+
+#include "benchmarks/bench.hxx"
+
+
+// Records of 4, 32 and 128 int members, each with short names ("m12") and with long names
+// sharing a long prefix, which is the worst case for name comparisons.
+#define BENCH_R4( F, S, H ) F( S, H##0 ) F( S, H##1 ) F( S, H##2 ) F( S, H##3 )
+#define BENCH_R8( F, S, H ) BENCH_R4( F, S, H ) F( S, H##4 ) F( S, H##5 ) F( S, H##6 ) F( S, H##7 )
+
+#define BENCH_WIDTH_4( F, S ) BENCH_R4( F, S, )
+#define BENCH_WIDTH_32( F, S ) BENCH_R8( F, S, 1 ) BENCH_R8( F, S, 2 ) BENCH_R8( F, S, 3 ) BENCH_R8( F, S, 4 )
+#define BENCH_WIDTH_128( F, S ) BENCH_WIDTH_32( F, S ) \
+	BENCH_R8( F, S, 5 ) BENCH_R8( F, S, 6 ) BENCH_R8( F, S, 7 ) BENCH_R8( F, S, 8 ) \
+	BENCH_R8( F, S, 9 ) BENCH_R8( F, S, 10 ) BENCH_R8( F, S, 11 ) BENCH_R8( F, S, 12 ) \
+	BENCH_R8( F, S, 13 ) BENCH_R8( F, S, 14 ) BENCH_R8( F, S, 15 ) BENCH_R8( F, S, 16 ) \
+	BENCH_R8( F, S, 17 ) BENCH_R8( F, S, 18 ) BENCH_R8( F, S, 19 ) BENCH_R8( F, S, 20 )
+
+#define BENCH_FIELD( S, I ) int m##I;
+#define BENCH_MEMBER( S, I ) , ::ap::insp::Member< &S::m##I >
+#define BENCH_SHORT_NAME( S, I ) template<> char const * const Member< &S::m##I >::kNAME = "m" #I;
+#define BENCH_LONG_NAME( S, I ) template<> char const * const Member< &S::m##I >::kNAME = "member_with_a_long_name_sharing_its_prefix_" #I;
+
+#define BENCH_RECORD( S, WIDTH ) \
+	struct S##Base { WIDTH( BENCH_FIELD, S##Base ) }; \
+	class S : public S##Base, public ::ap::insp::Introspector< S WIDTH( BENCH_MEMBER, S##Base ) > {};
+
+BENCH_RECORD( Short4, BENCH_WIDTH_4 )
+BENCH_RECORD( Long4, BENCH_WIDTH_4 )
+BENCH_RECORD( Short32, BENCH_WIDTH_32 )
+BENCH_RECORD( Long32, BENCH_WIDTH_32 )
+BENCH_RECORD( Short128, BENCH_WIDTH_128 )
+BENCH_RECORD( Long128, BENCH_WIDTH_128 )
+
+
+namespace ap
+{
+namespace insp
+{
+
+BENCH_WIDTH_4( BENCH_SHORT_NAME, Short4Base )
+BENCH_WIDTH_4( BENCH_LONG_NAME, Long4Base )
+BENCH_WIDTH_32( BENCH_SHORT_NAME, Short32Base )
+BENCH_WIDTH_32( BENCH_LONG_NAME, Long32Base )
+BENCH_WIDTH_128( BENCH_SHORT_NAME, Short128Base )
+BENCH_WIDTH_128( BENCH_LONG_NAME, Long128Base )
+
+}
+}
+
+
+// Iterations for 4 members, scaled down for wider records as dynamic paths are linear.
+constexpr unsigned long kITERATIONS = 5000000;
+constexpr unsigned long kTHROW_ITERATIONS = 100000;
+
+
+template< typename Function >
+void run( char const * record, char const * path, unsigned long iterations, Function && function )
+{
+	char label[ 64 ];
+	std::snprintf( label, sizeof( label ), "%-10s %s", record, path );
+	bench::run( label, iterations, function );
+}
+
+
+template< class Record, typename Object >
+void bench_access( char const * record, Object & object )
+{
+	constexpr unsigned kLAST = Record::Members::kSIZE - 1;
+	constexpr unsigned long kRUNS = kITERATIONS * 4 / Record::Members::kSIZE;
+	constexpr unsigned long kTHROW_RUNS = kTHROW_ITERATIONS * 4 / Record::Members::kSIZE;
+	using Last = typename ::ap::insp::member_at< kLAST, typename Record::Members >::type;
+
+	std::string const first_name = Record::member_name( 0 );
+	std::string const last_name = Record::member_name( kLAST );
+	std::string const missing_name = last_name + "_missing";
+
+	run( record, "direct last", kRUNS, [&]( unsigned long ) { bench::keep( bench::hide( &object )->*Last::kPOINTER ); } );
+	run( record, "get<RANK,T>() last", kRUNS, [&]( unsigned long ) { bench::keep( bench::hide( &object )->template get< kLAST, int >() ); } );
+	run( record, "get<T>(rank) first", kRUNS, [&]( unsigned long ) { bench::keep( object.template get< int >( bench::hide( 0u ) ) ); } );
+	run( record, "get<T>(rank) last", kRUNS, [&]( unsigned long ) { bench::keep( object.template get< int >( bench::hide( kLAST ) ) ); } );
+	run( record, "get<T>(name) first", kRUNS, [&]( unsigned long ) { bench::keep( object.template get< int >( first_name ) ); } );
+	run( record, "get<T>(name) last", kRUNS, [&]( unsigned long ) { bench::keep( object.template get< int >( last_name ) ); } );
+	run( record, "has_member last", kRUNS, [&]( unsigned long ) { bench::keep( Record::has_member( last_name ) ); } );
+	run( record, "has_member missing", kRUNS, [&]( unsigned long ) { bench::keep( Record::has_member( missing_name ) ); } );
+	run( record, "member_type(rank) last", kRUNS, [&]( unsigned long ) { bench::keep( &object.member_type( bench::hide( kLAST ) ) ); } );
+	run( record, "member_type(name) last", kRUNS, [&]( unsigned long ) { bench::keep( &object.member_type( last_name ) ); } );
+
+	run( record, "throw EBadType get<T>(name)", kTHROW_RUNS, [&]( unsigned long )
+	{
+		try { bench::keep( object.template get< long >( last_name ) ); } catch ( ::ap::insp::EBadType const & ) {}
+	} );
+
+	run( record, "throw EBadName get<T>(name)", kTHROW_RUNS, [&]( unsigned long )
+	{
+		try { bench::keep( object.template get< int >( missing_name ) ); } catch ( ::ap::insp::EBadName const & ) {}
+	} );
+
+	run( record, "throw EBadRank get<T>(rank)", kTHROW_RUNS, [&]( unsigned long )
+	{
+		try { bench::keep( object.template get< int >( bench::hide( kLAST + 1 ) ) ); } catch ( ::ap::insp::EBadRank const & ) {}
+	} );
+}
+
+
+template< class Record >
+void bench_record( char const * name )
+{
+	Record object{};
+	Record const & const_object = object;
+	char record[ 32 ];
+
+	std::snprintf( record, sizeof( record ), "%s", name );
+	bench_access< Record >( record, object );
+
+	std::snprintf( record, sizeof( record ), "%s const", name );
+	bench_access< Record >( record, const_object );
+
+	std::printf( "\n" );
+}
+
+
+int main()
+{
+	bench_record< Short4 >( "short4" );
+	bench_record< Long4 >( "long4" );
+	bench_record< Short32 >( "short32" );
+	bench_record< Long32 >( "long32" );
+	bench_record< Short128 >( "short128" );
+	bench_record< Long128 >( "long128" );
+
+	return 0;
+}
@@ -0,0 +1,56 @@
+#!/bin/sh
+# Build time and object size of one introspected record as its member count grows, with
+# the recursive Introspector and with FlatIntrospector.
+#
+# usage: compile_time.sh [compiler] [sources directory] [widths...]
+
+CXX=${1:-c++}
+SOURCES=${2:-$(dirname "$0")/..}
+[ $# -ge 2 ] && shift 2 || shift $#
+WIDTHS=${*:-8 32 64 128 256}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+
+generate() # width introspector
+{
+	last=$(( $1 - 1 ))
+
+	echo '#include <string>'
+	echo '#include "apophenic/Introspect.hxx"'
+	echo '#include "apophenic/IntrospectFlat.hxx"'
+	echo 'struct WideBase {'
+	for i in $(seq 0 $last); do echo "	int m$i;"; done
+	echo '};'
+	echo "class Wide : public WideBase, public ::ap::insp::$2< Wide"
+	for i in $(seq 0 $last); do echo "	, ::ap::insp::Member< &WideBase::m$i >"; done
+	echo '	> {};'
+	echo 'namespace ap { namespace insp {'
+	for i in $(seq 0 $last); do echo "template<> char const * const Member< &WideBase::m$i >::kNAME = \"m$i\";"; done
+	echo '} }'
+	echo 'int probe( Wide & wide, Wide const & other, std::string const & name, unsigned rank )'
+	echo '{'
+	echo '	return wide.get< int >( name ) + wide.get< int >( rank ) + other.get< int >( name ) + other.get< int >( rank )'
+	echo "		+ wide.get< $last, int >() + Wide::has_member( name ) + *Wide::member_name( rank ) + *other.member_type( name ).name();"
+	echo '}'
+}
+
+
+printf '%-8s %-20s %12s %14s\n' members introspector 'build (ms)' 'object (bytes)'
+
+for width in $WIDTHS; do
+	for introspector in Introspector FlatIntrospector; do
+		source="$WORK/wide_${width}_$introspector.cxx"
+		object="$WORK/wide_${width}_$introspector.o"
+		generate "$width" "$introspector" > "$source"
+
+		start=$(date +%s%N)
+		if "$CXX" -std=c++17 -O2 -I"$SOURCES" -c "$source" -o "$object" 2> "$WORK/errors"; then
+			finish=$(date +%s%N)
+			printf '%-8s %-20s %12d %14d\n' "$width" "$introspector" $(( ( finish - start ) / 1000000 )) $(wc -c < "$object")
+		else
+			printf '%-8s %-20s %12s %14s\n' "$width" "$introspector" failed -
+		fi
+	done
+done
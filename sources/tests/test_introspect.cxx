@@ -1,10 +1,34 @@
 #include <iostream>
 #include <string>
 #include <deque>
+#include <fstream>
+#include <set>
+#include <unordered_set>
+#include <vector>
+#include <limits>
+#include <tuple>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
 
 #include <gtest/gtest.h>
 
 #include "apophenic/Introspect.hxx"
+#include "apophenic/IntrospectCompare.hxx"
+#if ! defined( _WIN32 )
+#include "apophenic/IntrospectMapped.hxx"
+#endif
+#include "apophenic/IntrospectVersioned.hxx"
+#include "apophenic/IntrospectQuery.hxx"
+#include "apophenic/IntrospectLayout.hxx"
+#include "apophenic/IntrospectPath.hxx"
+#include "apophenic/IntrospectConvert.hxx"
+#include "apophenic/IntrospectIndex.hxx"
+#include "apophenic/IntrospectSort.hxx"
+#include "apophenic/IntrospectArena.hxx"
+#include "apophenic/IntrospectFlat.hxx"
+#include "apophenic/IntrospectSeqlock.hxx"
+#include "apophenic/IntrospectKey.hxx"
 
 
 struct AlphaBase
@@ -206,6 +230,1437 @@ TEST(IntrospectFixture, member_processing)
 }
 
 
+TEST(IntrospectFixture, hash_and_equality)
+{
+	int c = -37;
+	Alpha alpha(5, &c, "Hello", "Goodbye", true);
+	Alpha beta(5, &c, "Hello", "Goodbye", true);
+
+	::ap::insp::Hash<Alpha> hash;
+	::ap::insp::EqualTo<Alpha> equal;
+
+	EXPECT_TRUE( equal(alpha, beta) );
+	EXPECT_EQ( hash(alpha), hash(beta) );
+
+	beta.get<int>("Second") = 6;
+	EXPECT_FALSE( equal(alpha, beta) );
+	EXPECT_NE( hash(alpha), hash(beta) );
+
+	beta.get<int>("Second") = 5;
+	beta.get<std::string>("Fifth") = "Adios";
+	EXPECT_FALSE( equal(alpha, beta) );
+	EXPECT_NE( hash(alpha), hash(beta) );
+
+	beta.get<std::string>("Fifth") = "Goodbye";
+	beta.get<unsigned[5]>(0)[4] = 1;
+	EXPECT_FALSE( equal(alpha, beta) );
+	EXPECT_NE( hash(alpha), hash(beta) );
+
+	std::unordered_set<Alpha, ::ap::insp::Hash<Alpha>, ::ap::insp::EqualTo<Alpha>> set;
+	set.insert(alpha);
+	set.insert(beta);
+	set.insert(Alpha(5, &c, "Hello", "Goodbye", true));
+	EXPECT_EQ( 2u, set.size() );
+}
+
+
+TEST(IntrospectFixture, ordering)
+{
+	int c = -37;
+	Alpha alpha(5, &c, "Hello", "Zulu", true);
+	Alpha beta(6, &c, "Hello", "Alpha", true);
+
+	EXPECT_TRUE( ::ap::insp::Less<Alpha>()(alpha, beta) );
+	EXPECT_FALSE( ::ap::insp::Less<Alpha>()(beta, alpha) );
+	EXPECT_FALSE( ::ap::insp::Less<Alpha>()(alpha, alpha) );
+
+	using ByFifth = ::ap::insp::Less<Alpha, ::ap::insp::Member< &AlphaBase::five >>;
+	EXPECT_TRUE( ByFifth()(beta, alpha) );
+
+	using ByFourthThenDescendingSecond = ::ap::insp::Less<
+			Alpha
+		,	::ap::insp::Member< &AlphaBase::four >
+		,	::ap::insp::Descending< ::ap::insp::Member< &AlphaBase::two > >
+		>;
+	EXPECT_TRUE( ByFourthThenDescendingSecond()(beta, alpha) );
+
+	std::set<Alpha, ByFifth> sorted;
+	sorted.insert(alpha);
+	sorted.insert(beta);
+	EXPECT_EQ( "Alpha", sorted.begin()->get<std::string>("Fifth") );
+}
+
+
+struct BetaBase
+{
+	long two;
+	std::string five;
+};
+
+
+class Beta
+	: public BetaBase
+	, public ::ap::insp::Introspector<
+			Beta
+		,	::ap::insp::Member< &BetaBase::two >
+		,	::ap::insp::Member< &BetaBase::five >
+		>
+{};
+
+
+namespace ap
+{
+namespace insp
+{
+
+template<> const char * const Member< &BetaBase::two >::kNAME = "Second";
+template<> const char * const Member< &BetaBase::five >::kNAME = "Fifth";
+
+}
+}
+
+
+struct PointBase
+{
+	int x;
+	int y;
+};
+
+
+class Point
+	: public PointBase
+	, public ::ap::insp::Introspector<
+			Point
+		,	::ap::insp::Member< &PointBase::x >
+		,	::ap::insp::Member< &PointBase::y >
+		>
+{};
+
+
+namespace ap
+{
+namespace insp
+{
+
+template<> const char * const Member< &PointBase::x >::kNAME = "x";
+template<> const char * const Member< &PointBase::y >::kNAME = "y";
+
+}
+}
+
+
+#if ! defined( _WIN32 )
+struct AlphaRecordBase
+{
+	unsigned one[5];
+	int two;
+	std::string const four;
+	std::string five;
+	bool six;
+};
+
+
+class AlphaRecord
+	: public AlphaRecordBase
+	, public ::ap::insp::Introspector<
+			AlphaRecord
+		,	::ap::insp::Member< &AlphaRecordBase::one >
+		,	::ap::insp::Member< &AlphaRecordBase::two >
+		,	::ap::insp::Member< &AlphaRecordBase::four >
+		,	::ap::insp::Member< &AlphaRecordBase::five >
+		,	::ap::insp::Member< &AlphaRecordBase::six >
+		>
+{
+public:
+	AlphaRecord(int b, std::string d, std::string e, bool f)
+		: AlphaRecordBase{ {}, b, d, e, f } {}
+};
+
+
+namespace ap
+{
+namespace insp
+{
+
+template<> const char * const Member< &AlphaRecordBase::one >::kNAME = "First";
+template<> const char * const Member< &AlphaRecordBase::two >::kNAME = "Second";
+template<> const char * const Member< &AlphaRecordBase::four >::kNAME = "Fourth";
+template<> const char * const Member< &AlphaRecordBase::five >::kNAME = "Fifth";
+template<> const char * const Member< &AlphaRecordBase::six >::kNAME = "Sixth";
+
+}
+}
+
+
+class MappedFixture : public ::testing::TestWithParam< ::ap::insp::eMappedLayout >
+{
+protected:
+	void SetUp() override
+	{
+		_path = ::testing::TempDir() + "apophenic_mapped.bin";
+
+		for ( int i = 0; i < 100; ++i )
+		{
+			_records.emplace_back( i * 3, "Hello" + std::to_string(i), std::string(i % 7, 'x'), i % 2 == 0 );
+			_records.back().get<unsigned[5]>(0)[2] = i;
+		}
+
+		::ap::insp::write_mapped<AlphaRecord>( _path, _records.begin(), _records.end(), GetParam() );
+	}
+
+	void TearDown() override { std::remove( _path.c_str() ); }
+
+	void corrupt( std::streamoff position, std::uint64_t value )
+	{
+		std::fstream file( _path, std::ios::binary | std::ios::in | std::ios::out );
+		file.seekp( position );
+		file.write( reinterpret_cast< char const * >( &value ), sizeof( value ) );
+	}
+
+	std::string _path;
+	std::deque<AlphaRecord> _records;
+};
+
+
+TEST_P(MappedFixture, lazy_access)
+{
+	::ap::insp::MappedFile<AlphaRecord> file( _path );
+
+	ASSERT_EQ( 100u, file.size() );
+	EXPECT_EQ( GetParam(), file.layout() );
+
+	for ( unsigned i = 0; i < 100; ++i )
+	{
+		EXPECT_EQ( int(i * 3), (file.get<1,int>)(i) );
+		EXPECT_EQ( "Hello" + std::to_string(i), (file.get<2,const std::string>)(i) );
+		EXPECT_EQ( std::string(i % 7, 'x'), file.get<std::string>(i, "Fifth") );
+		EXPECT_EQ( i % 2 == 0, file.get<bool>(i, 4u) );
+		EXPECT_EQ( i, file.get<unsigned[5]>(i, "First")[2] );
+	}
+
+	::ap::insp::MappedColumn<int> const seconds = file.column<int>( "Second" );
+	long sum = 0;
+	for ( unsigned i = 0; i < file.size(); ++i ) sum += seconds[i];
+	EXPECT_EQ( 3 * 99 * 100 / 2, sum );
+
+	EXPECT_THROW( file.column<long>( "Second" ), ::ap::insp::EBadType );
+	EXPECT_THROW( file.column<int>( "Secnod" ), ::ap::insp::EBadName );
+	EXPECT_THROW( file.column<int>( 5u ), ::ap::insp::EBadRank );
+}
+
+
+TEST_P(MappedFixture, schema_mismatch)
+{
+	EXPECT_THROW( ::ap::insp::MappedFile<Beta> file( _path ), ::ap::insp::EBadSchema );
+	EXPECT_THROW( ::ap::insp::MappedFile<AlphaRecord> file( _path + ".missing" ), ::ap::insp::EBadFile );
+}
+
+
+
+TEST_P(MappedFixture, without_heap)
+{
+	std::vector<Point> points;
+	for ( int i = 0; i < 10; ++i )
+	{
+		points.emplace_back();
+		points.back().x = i;
+		points.back().y = -i;
+	}
+
+	std::string const path = _path + ".points";
+	::ap::insp::write_mapped<Point>( path, points.begin(), points.end(), GetParam() );
+
+	{
+		::ap::insp::MappedFile<Point> file( path );
+		ASSERT_EQ( 10u, file.size() );
+		EXPECT_EQ( 7, (file.get<0,int>)(7) );
+		EXPECT_EQ( -9, file.get<int>(9, "y") );
+	}
+
+	std::remove( path.c_str() );
+}
+
+
+TEST_P(MappedFixture, corrupt_heap)
+{
+	corrupt( 32, 4 );
+
+	::ap::insp::MappedFile<AlphaRecord> file( _path );
+	EXPECT_EQ( 3, file.get<int>(1, "Second") );
+	EXPECT_THROW( file.get<std::string>(99, "Fourth"), ::ap::insp::EBadFile );
+}
+
+
+TEST_P(MappedFixture, corrupt_heap_bounds)
+{
+	corrupt( 24, std::uint64_t(-16) );
+	corrupt( 32, 32 );
+	EXPECT_THROW( ::ap::insp::MappedFile<AlphaRecord> file( _path ), ::ap::insp::EBadFile );
+}
+
+
+TEST_P(MappedFixture, corrupt_record_count)
+{
+	corrupt( 16, ( std::uint64_t(1) << 63 ) + 1 );
+	EXPECT_THROW( ::ap::insp::MappedFile<AlphaRecord> file( _path ), ::ap::insp::EBadSchema );
+}
+INSTANTIATE_TEST_SUITE_P(
+		IntrospectFixture
+	,	MappedFixture
+	,	::testing::Values( ::ap::insp::eMappedLayout::ROWS, ::ap::insp::eMappedLayout::COLUMNS )
+	);
+#endif
+
+
+struct OrderV1Base
+{
+	long id;
+	double price;
+	std::string note;
+};
+
+
+class OrderV1
+	: public OrderV1Base
+	, public ::ap::insp::Introspector<
+			OrderV1
+		,	::ap::insp::Member< &OrderV1Base::id >
+		,	::ap::insp::Member< &OrderV1Base::price >
+		,	::ap::insp::Member< &OrderV1Base::note >
+		>
+{};
+
+
+struct OrderV2Base
+{
+	std::string note;
+	long id;
+	int quantity;
+	double price;
+};
+
+
+class OrderV2
+	: public OrderV2Base
+	, public ::ap::insp::Introspector<
+			OrderV2
+		,	::ap::insp::Member< &OrderV2Base::note >
+		,	::ap::insp::Member< &OrderV2Base::id >
+		,	::ap::insp::Member< &OrderV2Base::quantity >
+		,	::ap::insp::Member< &OrderV2Base::price >
+		>
+{};
+
+
+namespace ap
+{
+namespace insp
+{
+
+template<> const char * const Member< &OrderV1Base::id >::kNAME = "id";
+template<> const char * const Member< &OrderV1Base::price >::kNAME = "price";
+template<> const char * const Member< &OrderV1Base::note >::kNAME = "note";
+template<> const char * const Member< &OrderV2Base::note >::kNAME = "note";
+template<> const char * const Member< &OrderV2Base::id >::kNAME = "id";
+template<> const char * const Member< &OrderV2Base::quantity >::kNAME = "quantity";
+template<> const char * const Member< &OrderV2Base::price >::kNAME = "price";
+
+}
+}
+
+
+TEST(IntrospectFixture, versioned_same_schema)
+{
+	OrderV2 written;
+	written.note = "same";
+	written.id = 42;
+	written.quantity = 7;
+	written.price = 1.5;
+
+	std::string buffer;
+	::ap::insp::encode_versioned( written, buffer );
+
+	::ap::insp::SchemaRegistry registry;
+	::ap::insp::VersionedDecoder<OrderV2> decoder( registry );
+	OrderV2 read;
+
+	EXPECT_EQ( buffer.size(), decoder.decode( buffer.data(), buffer.size(), read ) );
+	EXPECT_EQ( "same", read.note );
+	EXPECT_EQ( 42, read.id );
+	EXPECT_EQ( 7, read.quantity );
+	EXPECT_EQ( 1.5, read.price );
+	EXPECT_EQ( 0u, decoder.nb_plans() );
+
+	EXPECT_THROW( decoder.decode( buffer.data(), buffer.size() - 1, read ), ::ap::insp::ETruncated );
+}
+
+
+TEST(IntrospectFixture, versioned_schema_evolution)
+{
+	std::string schema_bytes;
+	::ap::insp::encode_schema( ::ap::insp::versioned_schema<OrderV1>(), schema_bytes );
+
+	::ap::insp::SchemaRegistry registry;
+	registry.add( ::ap::insp::decode_schema( schema_bytes.data(), schema_bytes.size() ) );
+	registry.add<OrderV2>();
+
+	std::string buffer;
+	for ( long i = 0; i < 10; ++i )
+	{
+		OrderV1 old;
+		old.id = i;
+		old.price = i * 0.5;
+		old.note = "v1 #" + std::to_string(i);
+		::ap::insp::encode_versioned( old, buffer );
+	}
+
+	::ap::insp::VersionedDecoder<OrderV2> decoder( registry );
+	std::size_t offset = 0;
+
+	for ( long i = 0; i < 10; ++i )
+	{
+		OrderV2 read;
+		read.quantity = -1;
+		offset += decoder.decode( buffer.data() + offset, buffer.size() - offset, read );
+
+		EXPECT_EQ( i, read.id );
+		EXPECT_EQ( i * 0.5, read.price );
+		EXPECT_EQ( "v1 #" + std::to_string(i), read.note );
+		EXPECT_EQ( -1, read.quantity );
+	}
+
+	EXPECT_EQ( buffer.size(), offset );
+	EXPECT_EQ( 1u, decoder.nb_plans() );
+
+	OrderV2 newer;
+	newer.note = "v2";
+	newer.id = 99;
+	newer.quantity = 3;
+	newer.price = 2.25;
+	buffer.clear();
+	::ap::insp::encode_versioned( newer, buffer );
+
+	::ap::insp::VersionedDecoder<OrderV1> old_decoder( registry );
+	OrderV1 old;
+	EXPECT_EQ( buffer.size(), old_decoder.decode( buffer.data(), buffer.size(), old ) );
+	EXPECT_EQ( 99, old.id );
+	EXPECT_EQ( 2.25, old.price );
+	EXPECT_EQ( "v2", old.note );
+
+	::ap::insp::SchemaRegistry empty;
+	::ap::insp::VersionedDecoder<OrderV1> blind_decoder( empty );
+	EXPECT_THROW( blind_decoder.decode( buffer.data(), buffer.size(), old ), ::ap::insp::EUnknownSchema );
+}
+
+
+TEST(IntrospectFixture, member_handle)
+{
+	int c = -37;
+	Alpha alpha(5, &c, "Hello", "Goodbye", true);
+
+	::ap::insp::MemberHandle<Alpha, std::string> const fifth( "Fifth" );
+	EXPECT_EQ( 4u, fifth.rank() );
+	EXPECT_EQ( "Goodbye", fifth.get( alpha ) );
+	fifth.get( alpha ) = "Adios";
+	EXPECT_EQ( "Adios", alpha.get<std::string>( "Fifth" ) );
+
+	::ap::insp::MemberHandle<Alpha, int> const second( 1u );
+	EXPECT_EQ( 5, second.get( static_cast<Alpha const &>( alpha ) ) );
+
+	typedef ::ap::insp::MemberHandle<Alpha, int> IntHandle;
+	EXPECT_THROW( IntHandle( "Fist" ), ap::insp::EBadName );
+	EXPECT_THROW( IntHandle( "Fifth" ), ap::insp::EBadType );
+	EXPECT_THROW( IntHandle( 6u ), ap::insp::EBadRank );
+}
+
+
+TEST(IntrospectFixture, prepared_query)
+{
+	int c = -37;
+	std::deque<Alpha> alphas;
+	for ( int i = 0; i < 1000; ++i )
+	{
+		alphas.emplace_back( i, &c, "Hello", "Goodbye" + std::to_string(i % 10), i % 3 == 0 );
+	}
+
+	using ::ap::insp::field;
+
+	auto const query = ::ap::insp::prepare<Alpha>(
+			field<int>( "Second" ) > 5
+		&&	( field<bool>( "Sixth" ) == true || field<std::string>( "Fifth" ) == "Goodbye1" )
+		&&	! ( field<int>( "Second" ) >= 990 )
+		);
+
+	std::vector<std::size_t> expected;
+	std::vector<std::string> expected_fifth;
+	for ( std::size_t i = 0; i < alphas.size(); ++i )
+	{
+		if ( i > 5 && ( i % 3 == 0 || i % 10 == 1 ) && i < 990 )
+		{
+			expected.push_back( i );
+			expected_fifth.push_back( alphas[i].five );
+		}
+	}
+
+	EXPECT_EQ( expected.size(), query.count( alphas ) );
+	EXPECT_EQ( expected, query.indices( alphas ) );
+	EXPECT_EQ( expected, query.indices( alphas, 4 ) );
+	EXPECT_EQ( expected_fifth, query.select<std::string>( "Fifth", alphas ) );
+	EXPECT_EQ( expected_fifth, query.select<std::string>( "Fifth", alphas, 3 ) );
+
+	::ap::insp::ThreadPool pool( 3 );
+	for ( unsigned run = 0; run < 3; ++run )
+	{
+		EXPECT_EQ( expected, query.indices( alphas, pool ) );
+		EXPECT_EQ( expected_fifth, query.select<std::string>( "Fifth", alphas, pool ) );
+	}
+
+	EXPECT_THROW( ::ap::insp::prepare<Alpha>( field<int>( "Secnod" ) > 5 ), ap::insp::EBadName );
+	EXPECT_THROW( ::ap::insp::prepare<Alpha>( field<long>( "Second" ) > 5 ), ap::insp::EBadType );
+}
+
+
+struct HolesBase
+{
+	bool a;
+	double b;
+	bool c;
+	int d;
+	short e;
+};
+
+
+class Holes
+	: public HolesBase
+	, public ::ap::insp::Introspector<
+			Holes
+		,	::ap::insp::Member< &HolesBase::a >
+		,	::ap::insp::Member< &HolesBase::b >
+		,	::ap::insp::Member< &HolesBase::c >
+		,	::ap::insp::Member< &HolesBase::d >
+		,	::ap::insp::Member< &HolesBase::e >
+		>
+{};
+
+
+namespace ap
+{
+namespace insp
+{
+
+template<> const char * const Member< &HolesBase::a >::kNAME = "a";
+template<> const char * const Member< &HolesBase::b >::kNAME = "b";
+template<> const char * const Member< &HolesBase::c >::kNAME = "c";
+template<> const char * const Member< &HolesBase::d >::kNAME = "d";
+template<> const char * const Member< &HolesBase::e >::kNAME = "e";
+
+}
+}
+
+
+TEST(IntrospectFixture, layout_report)
+{
+	using Layout = ::ap::insp::Layout<Holes>;
+	static_assert( 1 + 8 + 1 + 4 + 2 == Layout::kPAYLOAD, "payload" );
+	static_assert( 16 == Layout::kPACKED_SIZE, "packed size" );
+	static_assert( 0 == Layout::kPACKED_OFFSETS[1], "double first" );
+
+	std::vector<::ap::insp::MemberLayout> const report = ::ap::insp::layout_report<Holes>();
+	ASSERT_EQ( 5u, report.size() );
+	EXPECT_STREQ( "a", report[0].name );
+	EXPECT_EQ( 0u, report[0].offset );
+	EXPECT_EQ( 7u, report[0].padding );
+	EXPECT_STREQ( "b", report[1].name );
+	EXPECT_EQ( 8u, report[1].offset );
+	EXPECT_EQ( 3u, report[2].padding );
+	EXPECT_EQ( sizeof(Holes) - Layout::kPAYLOAD, ::ap::insp::padding_bytes<Holes>() );
+
+	EXPECT_LE( ::ap::insp::Layout<Alpha>::kPACKED_SIZE, sizeof(AlphaBase) );
+	EXPECT_EQ( sizeof(AlphaBase) - ::ap::insp::Layout<Alpha>::kPAYLOAD, ::ap::insp::padding_bytes<Alpha>() );
+}
+
+
+// Counts live instances; the construction numbered fail_at throws.
+struct Tracked
+{
+	Tracked() { if ( 0 == fail_at-- ) throw std::runtime_error( "construct" ); ++alive; }
+	Tracked( Tracked const & ) : Tracked() {}
+	~Tracked() { --alive; }
+
+	static inline int alive = 0;
+	static inline int fail_at = -1;
+};
+
+
+struct TrackedArrayBase
+{
+	long id;
+	Tracked items[2][3];
+};
+
+
+class TrackedArray
+	: public TrackedArrayBase
+	, public ::ap::insp::Introspector<
+			TrackedArray
+		,	::ap::insp::Member< &TrackedArrayBase::id >
+		,	::ap::insp::Member< &TrackedArrayBase::items >
+		>
+{};
+
+
+namespace ap
+{
+namespace insp
+{
+
+template<> const char * const Member< &TrackedArrayBase::id >::kNAME = "id";
+template<> const char * const Member< &TrackedArrayBase::items >::kNAME = "items";
+
+}
+}
+
+
+TEST(IntrospectFixture, packed_mirror)
+{
+	static_assert( std::is_nothrow_move_constructible< ::ap::insp::Packed<Alpha> >::value, "nothrow move" );
+	static_assert( ! std::is_nothrow_move_constructible< ::ap::insp::Packed<TrackedArray> >::value, "throwing move" );
+
+	static_assert( sizeof(::ap::insp::Packed<Holes>) == 16, "packed" );
+	static_assert( sizeof(::ap::insp::Packed<Holes>) < sizeof(Holes), "smaller" );
+
+	int c = -37;
+	Alpha alpha(5, &c, "Hello", "Goodbye", true);
+	alpha.get<unsigned[5]>(0)[3] = 12;
+
+	::ap::insp::Packed<Alpha> packed( alpha );
+	EXPECT_EQ( 6u, packed.nb_members() );
+	EXPECT_EQ( 12u, packed.get<unsigned[5]>("First")[3] );
+	EXPECT_EQ( 5, packed.get<int>(1) );
+	EXPECT_EQ( &c, (packed.get<2,int *>)() );
+	EXPECT_EQ( "Hello", packed.get<const std::string>("Fourth") );
+	EXPECT_EQ( "Goodbye", packed.get<std::string>(4) );
+	EXPECT_TRUE( packed.get<bool>("Sixth") );
+	EXPECT_EQ( typeid(int), packed.member_type("Second") );
+
+	EXPECT_THROW( packed.get<int>(6), ap::insp::EBadRank );
+	EXPECT_THROW( packed.get<int>("Fist"), ap::insp::EBadName );
+	EXPECT_THROW( packed.get<unsigned>("First"), ap::insp::EBadType );
+
+	packed.get<std::string>("Fifth") = "Adios";
+	packed.get<int>("Second") = 8;
+
+	::ap::insp::Packed<Alpha> copy( packed );
+	::ap::insp::Packed<Alpha> moved( std::move( copy ) );
+	EXPECT_EQ( "Adios", moved.get<std::string>("Fifth") );
+
+	::ap::insp::Packed<Alpha> assigned;
+	EXPECT_EQ( "", assigned.get<std::string>("Fifth") );
+	EXPECT_EQ( 0, assigned.get<int>("Second") );
+	assigned = moved;
+
+	Alpha unpacked(0, nullptr, "Hello", "", false);
+	assigned.unpack( unpacked );
+	EXPECT_EQ( "Adios", unpacked.five );
+	EXPECT_EQ( 8, unpacked.two );
+	EXPECT_EQ( &c, unpacked.three );
+	EXPECT_EQ( 12u, unpacked.one[3] );
+	EXPECT_TRUE( unpacked.six );
+
+	::ap::insp::EqualTo<Alpha> equal;
+	alpha.get<std::string>("Fifth") = "Adios";
+	alpha.get<int>("Second") = 8;
+	EXPECT_TRUE( equal( alpha, unpacked ) );
+}
+
+
+TEST(IntrospectFixture, packed_array_throwing_element)
+{
+	for ( int fail_at : { 0, 2, 4, 5 } )
+	{
+		Tracked::fail_at = fail_at;
+		EXPECT_THROW( ::ap::insp::Packed<TrackedArray>(), std::runtime_error );
+		EXPECT_EQ( 0, Tracked::alive ) << fail_at;
+	}
+
+	Tracked::fail_at = -1;
+	{
+		TrackedArray tracked;
+		tracked.id = 1;
+		Tracked::fail_at = 3;
+		EXPECT_THROW( ::ap::insp::Packed<TrackedArray>{ tracked }, std::runtime_error );
+		EXPECT_EQ( 6, Tracked::alive );
+	}
+	EXPECT_EQ( 0, Tracked::alive );
+	Tracked::fail_at = -1;
+}
+
+
+struct VenueBase
+{
+	int id;
+	std::string code;
+};
+
+
+class Venue
+	: public VenueBase
+	, public ::ap::insp::Introspector<
+			Venue
+		,	::ap::insp::Member< &VenueBase::id >
+		,	::ap::insp::Member< &VenueBase::code >
+		>
+{};
+
+
+struct InstrumentBase
+{
+	long isin;
+	Venue venue;
+};
+
+
+class Instrument
+	: public InstrumentBase
+	, public ::ap::insp::Introspector<
+			Instrument
+		,	::ap::insp::Member< &InstrumentBase::isin >
+		,	::ap::insp::Member< &InstrumentBase::venue >
+		>
+{};
+
+
+struct TradeBase
+{
+	int quantity;
+	Instrument instrument;
+};
+
+
+class Trade
+	: public TradeBase
+	, public ::ap::insp::Introspector<
+			Trade
+		,	::ap::insp::Member< &TradeBase::quantity >
+		,	::ap::insp::Member< &TradeBase::instrument >
+		>
+{};
+
+
+namespace ap
+{
+namespace insp
+{
+
+template<> const char * const Member< &VenueBase::id >::kNAME = "id";
+template<> const char * const Member< &VenueBase::code >::kNAME = "code";
+template<> const char * const Member< &InstrumentBase::isin >::kNAME = "isin";
+template<> const char * const Member< &InstrumentBase::venue >::kNAME = "venue";
+template<> const char * const Member< &TradeBase::quantity >::kNAME = "quantity";
+template<> const char * const Member< &TradeBase::instrument >::kNAME = "instrument";
+
+}
+}
+
+
+TEST(IntrospectFixture, static_path)
+{
+	Trade trade;
+	trade.quantity = 3;
+	trade.instrument.isin = 12345;
+	trade.instrument.venue.id = 7;
+	trade.instrument.venue.code = "XPAR";
+
+	using CodePath = ::ap::insp::Path<
+			::ap::insp::Member< &TradeBase::instrument >
+		,	::ap::insp::Member< &InstrumentBase::venue >
+		,	::ap::insp::Member< &VenueBase::code >
+		>;
+	static_assert( std::is_same< std::string, CodePath::type >::value, "path type" );
+
+	EXPECT_EQ( "instrument.venue.code", CodePath::name() );
+	EXPECT_EQ( "XPAR", CodePath::get( static_cast<Trade const &>( trade ) ) );
+	CodePath::get( trade ) = "XLON";
+	EXPECT_EQ( "XLON", trade.instrument.venue.code );
+
+	EXPECT_EQ( 12345, ( ::ap::insp::get_path< ::ap::insp::Member< &TradeBase::instrument >, ::ap::insp::Member< &InstrumentBase::isin > >( trade ) ) );
+}
+
+
+TEST(IntrospectFixture, dynamic_path)
+{
+	Trade trade;
+	trade.quantity = 3;
+	trade.instrument.isin = 12345;
+	trade.instrument.venue.id = 7;
+	trade.instrument.venue.code = "XPAR";
+
+	::ap::insp::PathHandle<Trade, std::string> const code( "instrument.venue.code" );
+	::ap::insp::PathHandle<Trade, int> const id( "instrument.venue.id" );
+	::ap::insp::PathHandle<Trade, int> const quantity( "quantity" );
+
+	EXPECT_EQ( "XPAR", code.get( static_cast<Trade const &>( trade ) ) );
+	EXPECT_EQ( 7, id.get( trade ) );
+	EXPECT_EQ( 3, quantity.get( trade ) );
+
+	id.get( trade ) = 8;
+	EXPECT_EQ( 8, trade.instrument.venue.id );
+
+	typedef ::ap::insp::PathHandle<Trade, int> IntPath;
+	EXPECT_THROW( IntPath( "instrument.venue.idx" ), ap::insp::EBadName );
+	EXPECT_THROW( IntPath( "instrument.isin.id" ), ap::insp::EBadName );
+	EXPECT_THROW( IntPath( "instrument.venue" ), ap::insp::EBadType );
+	EXPECT_THROW( IntPath( "instrument.venue.code" ), ap::insp::EBadType );
+	EXPECT_THROW( IntPath( "" ), ap::insp::EBadName );
+}
+
+
+struct AlphaRowBase
+{
+	unsigned one[5];
+	int two;
+	int * three;
+	std::string five;
+};
+
+
+class AlphaRow
+	: public AlphaRowBase
+	, public ::ap::insp::Introspector<
+			AlphaRow
+		,	::ap::insp::Member< &AlphaRowBase::one >
+		,	::ap::insp::Member< &AlphaRowBase::two >
+		,	::ap::insp::Member< &AlphaRowBase::three >
+		,	::ap::insp::Member< &AlphaRowBase::five >
+		>
+{};
+
+
+namespace ap
+{
+namespace insp
+{
+
+template<> const char * const Member< &AlphaRowBase::one >::kNAME = "First";
+template<> const char * const Member< &AlphaRowBase::two >::kNAME = "Second";
+template<> const char * const Member< &AlphaRowBase::three >::kNAME = "Third";
+template<> const char * const Member< &AlphaRowBase::five >::kNAME = "Fifth";
+
+}
+}
+
+
+struct AlphaNarrowBase
+{
+	bool one;
+	short two;
+	unsigned three[2];
+};
+
+
+class AlphaNarrow
+	: public AlphaNarrowBase
+	, public ::ap::insp::Introspector<
+			AlphaNarrow
+		,	::ap::insp::Member< &AlphaNarrowBase::one >
+		,	::ap::insp::Member< &AlphaNarrowBase::two >
+		,	::ap::insp::Member< &AlphaNarrowBase::three >
+		>
+{};
+
+
+namespace ap
+{
+namespace insp
+{
+
+template<> const char * const Member< &AlphaNarrowBase::one >::kNAME = "First";
+template<> const char * const Member< &AlphaNarrowBase::two >::kNAME = "Second";
+template<> const char * const Member< &AlphaNarrowBase::three >::kNAME = "Sixth";
+
+}
+}
+
+
+TEST(IntrospectFixture, convert)
+{
+	int c = -37;
+	Alpha alpha(5, &c, "Hello", "Goodbye", true);
+	alpha.get<unsigned[5]>(0)[1] = 11;
+
+	using AlphaToRow = ::ap::insp::Converter<Alpha, AlphaRow>;
+	EXPECT_EQ( 4u, AlphaToRow::nb_mapped() );
+	EXPECT_EQ( 2u, AlphaToRow::nb_steps() );
+
+	AlphaRow row = ::ap::insp::convert<AlphaRow>( alpha );
+	EXPECT_EQ( 11u, row.one[1] );
+	EXPECT_EQ( 5, row.two );
+	EXPECT_EQ( &c, row.three );
+	EXPECT_EQ( "Goodbye", row.five );
+
+	using RowToAlpha = ::ap::insp::Converter<AlphaRow, Alpha>;
+	row.five = "Adios";
+	row.two = 6;
+	Alpha back(0, nullptr, "Unchanged", "", true);
+	RowToAlpha::move( std::move( row ), back );
+	EXPECT_EQ( "Adios", back.five );
+	EXPECT_EQ( 6, back.two );
+	EXPECT_EQ( "Unchanged", back.four );
+	EXPECT_TRUE( back.six );
+
+	Beta beta = ::ap::insp::convert<Beta>( alpha );
+	EXPECT_EQ( 5l, beta.two );
+	EXPECT_EQ( "Goodbye", beta.five );
+	EXPECT_EQ( 2u, (::ap::insp::Converter<Alpha, Beta>::nb_steps()) );
+
+	// Array to scalar, narrowing and scalar to array are not conversions
+	EXPECT_EQ( 0u, (::ap::insp::Converter<Alpha, AlphaNarrow>::nb_mapped()) );
+}
+
+
+TEST(IntrospectFixture, bulk_convert)
+{
+	int c = -37;
+	std::vector<Alpha> alphas;
+	for ( int i = 0; i < 100; ++i )
+	{
+		alphas.emplace_back( i, &c, "Hello", std::to_string(i), false );
+		alphas.back().one[4] = i * 2;
+	}
+
+	std::vector<AlphaRow> rows( alphas.size() );
+	::ap::insp::Converter<Alpha, AlphaRow>::copy( alphas.data(), alphas.size(), rows.data() );
+
+	std::vector<Beta> betas( alphas.size() );
+	::ap::insp::Converter<Alpha, Beta>::copy( alphas.begin(), alphas.end(), betas.begin() );
+
+	for ( int i = 0; i < 100; ++i )
+	{
+		EXPECT_EQ( unsigned(i * 2), rows[i].one[4] );
+		EXPECT_EQ( i, rows[i].two );
+		EXPECT_EQ( &c, rows[i].three );
+		EXPECT_EQ( std::to_string(i), rows[i].five );
+		EXPECT_EQ( long(i), betas[i].two );
+		EXPECT_EQ( std::to_string(i), betas[i].five );
+	}
+}
+
+
+TEST(IntrospectFixture, indexed_collection)
+{
+	using Id = ::ap::insp::Member< &OrderV2Base::id >;
+	using Note = ::ap::insp::Member< &OrderV2Base::note >;
+	using Quantity = ::ap::insp::Member< &OrderV2Base::quantity >;
+
+	::ap::insp::IndexedCollection<
+			OrderV2
+		,	::ap::insp::Unique< Id >
+		,	::ap::insp::Multi< Note >
+		,	::ap::insp::Multi< Quantity >
+		> orders;
+
+	for ( long i = 0; i < 1000; ++i )
+	{
+		OrderV2 order;
+		order.note = i % 2 ? "odd" : "even";
+		order.id = i;
+		order.quantity = i % 10;
+		order.price = i * 0.5;
+		orders.insert( order );
+	}
+
+	EXPECT_EQ( 1000u, orders.size() );
+	EXPECT_EQ( 500u, orders.count< Note >( "odd" ) );
+	EXPECT_EQ( 100u, orders.count< Quantity >( 7 ) );
+	EXPECT_EQ( 0u, orders.count< Note >( "none" ) );
+
+	auto const id = orders.find< Id >( 421 );
+	ASSERT_NE( orders.npos, id );
+	EXPECT_EQ( 210.5, orders[ id ].price );
+	EXPECT_EQ( orders.npos, orders.find< Id >( 1000 ) );
+
+	OrderV2 duplicate;
+	duplicate.id = 421;
+	EXPECT_THROW( orders.insert( duplicate ), ::ap::insp::EDuplicateKey );
+	EXPECT_EQ( 1000u, orders.size() );
+
+	orders.update( id, []( OrderV2 & order ) { order.id = 5000; order.note = "moved"; } );
+	EXPECT_EQ( orders.npos, orders.find< Id >( 421 ) );
+	EXPECT_EQ( id, orders.find< Id >( 5000 ) );
+	EXPECT_EQ( 499u, orders.count< Note >( "odd" ) );
+	EXPECT_EQ( 1u, orders.count< Note >( "moved" ) );
+
+	EXPECT_THROW( orders.update( id, []( OrderV2 & order ) { order.id = 3; } ), ::ap::insp::EDuplicateKey );
+	EXPECT_EQ( id, orders.find< Id >( 5000 ) );
+	EXPECT_EQ( "moved", orders[ id ].note );
+
+	for ( long i = 0; i < 1000; i += 3 ) orders.erase( orders.find< Id >( i ) );
+	EXPECT_EQ( 666u, orders.size() );
+	EXPECT_THROW( orders.erase( orders.find< Id >( 3 ) ), ::ap::insp::EBadId );
+
+	for ( long i = 0; i < 1000; ++i )
+	{
+		if ( 421 == i ) continue;
+		auto const found = orders.find< Id >( i );
+		EXPECT_EQ( 0 != i % 3, orders.npos != found ) << i;
+		if ( orders.npos != found ) { EXPECT_EQ( i, orders[ found ].id ); }
+	}
+
+	long quantity_sum = 0;
+	orders.for_each_equal< Quantity >( 4, [&]( auto, OrderV2 const & order ) { quantity_sum += order.quantity; } );
+	EXPECT_EQ( 4 * 67, quantity_sum );
+
+	OrderV2 recycled;
+	recycled.id = 0;
+	recycled.note = "recycled";
+	auto const recycled_id = orders.insert( recycled );
+	EXPECT_LT( recycled_id, 1000u );
+	EXPECT_EQ( recycled_id, orders.find< Id >( 0 ) );
+}
+
+
+struct ThrowingAssign
+{
+	ThrowingAssign() = default;
+	ThrowingAssign( ThrowingAssign const & ) = default;
+	ThrowingAssign( ThrowingAssign && ) = default;
+	ThrowingAssign & operator=( ThrowingAssign const & ) = default;
+	ThrowingAssign & operator=( ThrowingAssign && other )
+	{
+		if ( other.armed ) throw std::runtime_error( "assign" );
+		return *this;
+	}
+
+	bool armed = false;
+};
+
+
+// Members assign in order: the order keys change before the guard throws.
+struct GuardedOrder : OrderV2
+{
+	ThrowingAssign guard;
+};
+
+
+TEST(IntrospectFixture, indexed_collection_throwing_replace)
+{
+	using Id = ::ap::insp::Member< &OrderV2Base::id >;
+	using Note = ::ap::insp::Member< &OrderV2Base::note >;
+
+	::ap::insp::IndexedCollection<
+			GuardedOrder
+		,	::ap::insp::Unique< Id >
+		,	::ap::insp::Multi< Note >
+		> orders;
+
+	GuardedOrder order;
+	order.id = 1;
+	order.note = "first";
+	auto const id = orders.insert( order );
+
+	order.id = 2;
+	order.note = "second";
+	order.guard.armed = true;
+	EXPECT_THROW( orders.replace( id, order ), std::runtime_error );
+
+	ASSERT_EQ( id, orders.find< Id >( 2 ) );
+	EXPECT_EQ( orders.npos, orders.find< Id >( 1 ) );
+	EXPECT_EQ( 1u, orders.count< Note >( "second" ) );
+	EXPECT_EQ( 0u, orders.count< Note >( "first" ) );
+
+	orders.erase( id );
+	EXPECT_EQ( 0u, orders.size() );
+	EXPECT_EQ( orders.npos, orders.find< Id >( 2 ) );
+}
+
+
+class SortFixture : public ::testing::TestWithParam< unsigned >
+{
+protected:
+	void SetUp() override
+	{
+		static char const * const kNOTES[] = { "delta", "alpha", "charlie", "bravo", "", "echo" };
+
+		for ( long i = 0; i < 20000; ++i )
+		{
+			OrderV2 order;
+			order.note = kNOTES[ ( i * 7 ) % 6 ];
+			order.id = ( i * 7919 ) % 20011 - 10000;
+			order.quantity = ( i * 31 ) % 97 - 48;
+			order.price = ( ( i * 13 ) % 1001 - 500 ) * 0.25;
+			orders.push_back( order );
+		}
+	}
+
+	template< typename Member, typename Greater = std::less<> >
+	std::vector< std::size_t > reference( Greater const & greater = Greater{} ) const
+	{
+		std::vector< std::size_t > indices( orders.size() );
+		for ( std::size_t i = 0; i < indices.size(); ++i ) indices[i] = i;
+		std::stable_sort( indices.begin(), indices.end(), [&]( std::size_t a, std::size_t b )
+		{
+			return greater( orders[a].*Member::kPOINTER, orders[b].*Member::kPOINTER );
+		} );
+		return indices;
+	}
+
+	std::vector< OrderV2 > orders;
+};
+
+
+TEST_P(SortFixture, radix)
+{
+	EXPECT_EQ( (reference< ::ap::insp::Member< &OrderV2Base::id > >()), ::ap::insp::sort_indices< OrderV2 >( orders, "id", ::ap::insp::eSortOrder::ASCENDING, GetParam() ) );
+	EXPECT_EQ( (reference< ::ap::insp::Member< &OrderV2Base::quantity > >()), ::ap::insp::sort_indices< OrderV2 >( orders, "quantity", ::ap::insp::eSortOrder::ASCENDING, GetParam() ) );
+	EXPECT_EQ(
+			(reference< ::ap::insp::Member< &OrderV2Base::price > >( std::greater<>() ))
+		,	::ap::insp::sort_indices< OrderV2 >( orders, "price", ::ap::insp::eSortOrder::DESCENDING, GetParam() )
+		);
+}
+
+
+TEST_P(SortFixture, merge)
+{
+	EXPECT_EQ( (reference< ::ap::insp::Member< &OrderV2Base::note > >()), ::ap::insp::stable_sort_indices< OrderV2 >( orders, "note", ::ap::insp::eSortOrder::ASCENDING, GetParam() ) );
+
+	std::vector< OrderV2 > sorted = orders;
+	::ap::insp::sort< OrderV2 >( sorted, "note", ::ap::insp::eSortOrder::DESCENDING, GetParam() );
+	EXPECT_TRUE( std::is_sorted( sorted.begin(), sorted.end(), []( OrderV2 const & a, OrderV2 const & b ) { return a.note > b.note; } ) );
+
+	EXPECT_THROW( ::ap::insp::sort< OrderV2 >( sorted, "nothing" ), ::ap::insp::EBadName );
+}
+
+
+TEST_P(SortFixture, group_by)
+{
+	::ap::insp::Grouping const grouping = ::ap::insp::group_by< OrderV2 >( orders, "quantity", GetParam() );
+	ASSERT_EQ( 97u, grouping.nb_groups() );
+
+	for ( std::size_t group = 0; group < grouping.nb_groups(); ++group )
+	{
+		int const quantity = orders[ grouping.indices[ grouping.bounds[ group ] ] ].quantity;
+		EXPECT_EQ( int(group) - 48, quantity );
+
+		for ( std::size_t i = grouping.bounds[ group ]; i < grouping.bounds[ group + 1 ]; ++i )
+		{
+			EXPECT_EQ( quantity, orders[ grouping.indices[i] ].quantity );
+			if ( i > grouping.bounds[ group ] ) { EXPECT_LT( grouping.indices[ i - 1 ], grouping.indices[i] ); }
+		}
+	}
+}
+
+
+
+TEST_P(SortFixture, shared_pool)
+{
+	::ap::insp::ThreadPool pool( GetParam() );
+
+	for ( unsigned run = 0; run < 3; ++run )
+	{
+		EXPECT_EQ( (reference< ::ap::insp::Member< &OrderV2Base::id > >()), ::ap::insp::sort_indices< OrderV2 >( orders, "id", ::ap::insp::eSortOrder::ASCENDING, pool ) );
+		EXPECT_EQ( (reference< ::ap::insp::Member< &OrderV2Base::note > >()), ::ap::insp::stable_sort_indices< OrderV2 >( orders, "note", ::ap::insp::eSortOrder::ASCENDING, pool ) );
+		EXPECT_EQ( 97u, ::ap::insp::group_by< OrderV2 >( orders, "quantity", pool ).nb_groups() );
+	}
+
+	std::vector< OrderV2 > sorted = orders;
+	::ap::insp::stable_sort< OrderV2 >( sorted, "quantity", ::ap::insp::eSortOrder::ASCENDING, pool );
+	EXPECT_TRUE( std::is_sorted( sorted.begin(), sorted.end(), []( OrderV2 const & a, OrderV2 const & b ) { return a.quantity < b.quantity; } ) );
+	EXPECT_EQ( GetParam(), pool.size() );
+}
+INSTANTIATE_TEST_SUITE_P(
+		IntrospectFixture
+	,	SortFixture
+	,	::testing::Values( 1u, 4u )
+	);
+
+
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+	std::size_t nb_allocations = 0;
+	std::size_t outstanding = 0;
+
+private:
+	void * do_allocate( std::size_t bytes, std::size_t alignment ) override
+	{
+		++nb_allocations;
+		outstanding += bytes;
+		return std::pmr::new_delete_resource()->allocate( bytes, alignment );
+	}
+
+	void do_deallocate( void * p, std::size_t bytes, std::size_t alignment ) override
+	{
+		outstanding -= bytes;
+		std::pmr::new_delete_resource()->deallocate( p, bytes, alignment );
+	}
+
+	bool do_is_equal( std::pmr::memory_resource const & other ) const noexcept override { return this == &other; }
+};
+
+
+TEST(IntrospectFixture, arena_record)
+{
+	int c = -37;
+	Alpha alpha(5, &c, "A constant string beyond small string capacity", "A mutable string beyond small string capacity", true);
+	alpha.one[2] = 9;
+
+	CountingResource upstream;
+	::ap::insp::Arena arena( ::ap::insp::eArenaMode::MONOTONIC, 4096, &upstream );
+
+	using Record = ::ap::insp::ArenaRecord< Alpha >;
+	std::vector< Record * > records;
+	for ( int i = 0; i < 1000; ++i ) records.push_back( arena.create< Record >( alpha ) );
+
+	Record & record = *records.back();
+	EXPECT_EQ( arena.resource(), record.get_allocator().resource() );
+	EXPECT_EQ( arena.resource(), (record.get< 4, std::pmr::string >().get_allocator().resource()) );
+	EXPECT_EQ( "A constant string beyond small string capacity", record.get< std::pmr::string >( "Fourth" ) );
+	EXPECT_EQ( 5, record.get< int >( 1 ) );
+	EXPECT_EQ( 9u, (record.get< 0, unsigned[5] >()[2]) );
+	EXPECT_THROW( record.get< std::string >( "Fifth" ), ::ap::insp::EBadType );
+	EXPECT_THROW( record.get< int >( "Nothing" ), ::ap::insp::EBadName );
+
+	record.get< std::pmr::string >( "Fifth" ) = "Changed";
+	record.get< int >( "Second" ) = 6;
+	Alpha unpacked( 0, nullptr, "Kept", "", false );
+	record.unpack( unpacked );
+	EXPECT_EQ( "Changed", unpacked.five );
+	EXPECT_EQ( "Kept", unpacked.four );
+	EXPECT_EQ( 6, unpacked.two );
+	EXPECT_EQ( &c, unpacked.three );
+	EXPECT_EQ( 9u, unpacked.one[2] );
+
+	// Chunks grow geometrically: far fewer upstream allocations than objects and strings.
+	EXPECT_LT( upstream.nb_allocations, 20u );
+	EXPECT_GT( upstream.outstanding, 1000 * sizeof( Record ) );
+
+	arena.release();
+	EXPECT_EQ( 0u, upstream.outstanding );
+}
+
+
+TEST(IntrospectFixture, arena_pool)
+{
+	int c = -37;
+	Alpha alpha(5, &c, "A constant string beyond small string capacity", "A mutable string beyond small string capacity", true);
+
+	CountingResource upstream;
+	::ap::insp::Arena arena( ::ap::insp::eArenaMode::POOLED, 4096, &upstream );
+
+	using Record = ::ap::insp::ArenaRecord< Alpha >;
+
+	for ( int round = 0; round < 100; ++round )
+	{
+		std::vector< Record * > records;
+		for ( int i = 0; i < 50; ++i ) records.push_back( arena.create< Record >( alpha ) );
+		for ( Record * record : records ) arena.destroy( record );
+	}
+
+	std::size_t const after_churn = upstream.nb_allocations;
+	Record * const copy = arena.create< Record >( *arena.create< Record >( alpha ) );
+	EXPECT_EQ( "A mutable string beyond small string capacity", copy->get< std::pmr::string >( "Fifth" ) );
+	EXPECT_EQ( arena.resource(), copy->get_allocator().resource() );
+
+	EXPECT_LT( after_churn, 20u );
+	arena.release();
+	EXPECT_EQ( 0u, upstream.outstanding );
+}
+
+
+class FlatAlpha
+	: public AlphaBase
+	, public ::ap::insp::FlatIntrospector<
+			FlatAlpha
+		,	::ap::insp::Member< &AlphaBase::one >
+		,	::ap::insp::Member< &AlphaBase::two >
+		,	::ap::insp::Member< &AlphaBase::three >
+		,	::ap::insp::Member< &AlphaBase::four >
+		,	::ap::insp::Member< &AlphaBase::five >
+		,	::ap::insp::Member< &AlphaBase::six >
+		>
+{
+public:
+	FlatAlpha(int b, int * c, std::string d, std::string e, bool f)
+		: AlphaBase{ {}, b, c, d, e, f } {}
+};
+
+
+TEST(IntrospectFixture, flat_introspector)
+{
+	int c = -37;
+	FlatAlpha alpha(5, &c, "Hello", "Goodbye", true);
+	FlatAlpha const & beta = alpha;
+
+	EXPECT_EQ(6u, FlatAlpha::nb_members());
+	EXPECT_STREQ("First", FlatAlpha::front_member_name());
+	EXPECT_EQ(alpha.one, alpha.front_member());
+
+	EXPECT_TRUE(beta.get<bool>(5));
+	EXPECT_EQ(std::string("Hello"), beta.get<const std::string>("Fourth"));
+	EXPECT_EQ(&c, beta.get<int *>("Third"));
+	EXPECT_EQ(5, (beta.get<1,int>)());
+
+	alpha.get<std::string>("Fifth") = "Adios";
+	alpha.get<int>(1) = -555;
+	alpha.get<unsigned[5]>("First")[3] = 12;
+	(alpha.get<5,bool>)() = false;
+
+	EXPECT_EQ(std::string("Adios"), alpha.five);
+	EXPECT_EQ(-555, alpha.two);
+	EXPECT_EQ(12u, alpha.one[3]);
+	EXPECT_FALSE(alpha.six);
+
+	EXPECT_TRUE(FlatAlpha::has_member("Sixth"));
+	EXPECT_FALSE(FlatAlpha::has_member("Seventh"));
+	EXPECT_STREQ("Fourth", FlatAlpha::member_name(3));
+	EXPECT_EQ(typeid(int *), alpha.member_type("Third"));
+	EXPECT_EQ(typeid(bool), alpha.member_type(5));
+
+	EXPECT_THROW(alpha.get<int>(6), ap::insp::EBadRank);
+	EXPECT_THROW(alpha.get<int>("Fist"), ap::insp::EBadName);
+	EXPECT_THROW(alpha.get<unsigned>("First"), ap::insp::EBadType);
+	EXPECT_THROW(FlatAlpha::member_name(6), ap::insp::EBadRank);
+	EXPECT_THROW(alpha.member_type("Fist"), ap::insp::EBadName);
+
+	::ap::insp::MemberHandle< FlatAlpha, std::string > const handle( "Fifth" );
+	EXPECT_EQ(std::string("Adios"), handle.get( beta ));
+
+	unsigned nb_visited = 0;
+	::ap::insp::for_each_member< FlatAlpha >( [&]( auto rank, auto member )
+	{
+		EXPECT_STREQ(FlatAlpha::member_name( rank ), decltype( member )::kNAME);
+		++nb_visited;
+	} );
+	EXPECT_EQ(6u, nb_visited);
+}
+
+
+TEST(IntrospectFixture, seqlocked)
+{
+	::ap::insp::Seqlocked< OrderV2 > order;
+	::ap::insp::MemberHandle< OrderV2, long > const id( "id" );
+	::ap::insp::MemberHandle< OrderV2, int > const quantity( "quantity" );
+	::ap::insp::MemberHandle< OrderV2, double > const price( "price" );
+
+	std::atomic< bool > done( false );
+	std::atomic< unsigned long > nb_reads( 0 );
+	std::vector< std::thread > readers;
+
+	for ( unsigned reader = 0; reader < 3; ++reader )
+	{
+		readers.emplace_back( [&]
+		{
+			while ( false == done.load() )
+			{
+				auto const snapshot = order.get( id, quantity, price );
+				EXPECT_EQ( std::get< 0 >( snapshot ) * 2, std::get< 1 >( snapshot ) );
+				EXPECT_EQ( std::get< 0 >( snapshot ) * 0.5, std::get< 2 >( snapshot ) );
+
+				long const by_name = order.get< long >( "id" );
+				EXPECT_LE( std::get< 0 >( snapshot ), by_name );
+				++nb_reads;
+			}
+		} );
+	}
+
+	for ( long i = 1; i <= 100000; ++i )
+	{
+		order.write( [i]( OrderV2 & object )
+		{
+			object.id = i;
+			object.note = std::to_string( i );
+			object.quantity = int( i * 2 );
+			object.price = i * 0.5;
+		} );
+	}
+
+	while ( nb_reads.load() < 1000 ) std::this_thread::yield();
+	done = true;
+	for ( std::thread & reader : readers ) reader.join();
+
+	EXPECT_EQ( 200000u, order.version() );
+	EXPECT_EQ( 100000, (order.get< 1, long >()) );
+	EXPECT_EQ( "100000", order.unsafe_object().note );
+
+	order.set< int >( 2u, 7 );
+	EXPECT_EQ( 7, order.get< int >( "quantity" ) );
+	EXPECT_THROW( order.set< int >( "id", 7 ), ::ap::insp::EBadType );
+	EXPECT_EQ( 0u, order.version() % 2 );
+}
+
+
+TEST(IntrospectFixture, key_codec)
+{
+	using Note = ::ap::insp::Member< &OrderV2Base::note >;
+	using Id = ::ap::insp::Member< &OrderV2Base::id >;
+	using Quantity = ::ap::insp::Member< &OrderV2Base::quantity >;
+	using Price = ::ap::insp::Member< &OrderV2Base::price >;
+	using Codec = ::ap::insp::KeyCodec< OrderV2, Note, ::ap::insp::Descending< Price >, Id >;
+	using Key = ::ap::insp::KeyBuffer<>;
+
+	static char const * const kNOTES[] = { "", "a", nullptr, "ab", "b" };
+	static double const kPRICES[] = { -1e9, -2.5, -0.0, 1e-300, 3.0, 1e9 };
+	static long const kIDS[] = { std::numeric_limits< long >::min(), -1, 0, 1, std::numeric_limits< long >::max() };
+
+	std::vector< OrderV2 > orders;
+	for ( unsigned n = 0; n < 5; ++n )
+	{
+		for ( double price : kPRICES )
+		{
+			for ( long id : kIDS )
+			{
+				OrderV2 order;
+				order.note = 2 == n ? std::string( "a\0b", 3 ) : kNOTES[n];
+				order.price = price;
+				order.id = id;
+				order.quantity = 0;
+				orders.push_back( order );
+			}
+		}
+	}
+
+	auto const less = []( OrderV2 const & a, OrderV2 const & b )
+	{
+		return std::make_tuple( a.note, -a.price, a.id ) < std::make_tuple( b.note, -b.price, b.id );
+	};
+
+	for ( OrderV2 const & a : orders )
+	{
+		Key const key_a = Key::encode< Codec >( a );
+
+		OrderV2 decoded;
+		decoded.quantity = 42;
+		EXPECT_EQ( key_a.size(), Codec::decode( key_a.data(), key_a.size(), decoded ) );
+		EXPECT_EQ( a.note, decoded.note );
+		EXPECT_EQ( a.price, decoded.price );
+		EXPECT_EQ( a.id, decoded.id );
+		EXPECT_EQ( 42, decoded.quantity );
+
+		for ( OrderV2 const & b : orders )
+		{
+			EXPECT_EQ( less( a, b ), key_a < Key::encode< Codec >( b ) );
+		}
+	}
+
+	OrderV2 order = orders.back();
+	order.quantity = -3;
+	unsigned char buffer[ 64 ];
+	std::size_t const size = ::ap::insp::KeyCodec< OrderV2 >::encode( order, buffer, sizeof( buffer ) );
+	EXPECT_EQ( 0x7f, buffer[ size - 8 - 4 ] );
+
+	OrderV2 all;
+	EXPECT_EQ( size, ::ap::insp::KeyCodec< OrderV2 >::decode( buffer, size, all ) );
+	EXPECT_EQ( -3, all.quantity );
+	EXPECT_THROW( ::ap::insp::KeyCodec< OrderV2 >::decode( buffer, size - 1, all ), ::ap::insp::EBadKey );
+	EXPECT_THROW( ::ap::insp::KeyCodec< OrderV2 >::encode( order, buffer, 8 ), ::ap::insp::EKeyTooLong );
+
+	Key const quantity_key = Key::encode< ::ap::insp::KeyCodec< OrderV2, Quantity > >( order );
+	ASSERT_EQ( 4u, quantity_key.size() );
+	EXPECT_EQ( 0x7f, quantity_key.data()[0] );
+	EXPECT_EQ( 0xfd, quantity_key.data()[3] );
+}
+
+
 int main(int argc, char **argv)
 {
 	::testing::InitGoogleTest(&argc, argv);
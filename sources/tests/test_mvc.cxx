@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <string>
+#include <thread>
 #include <vector>
 #include <list>
 
@@ -6,6 +10,7 @@
 #include <gmock/gmock.h>
 
 #include "apophenic/MVC.hxx"
+#include "apophenic/MVCAsync.hxx"
 
 
 using ::testing::_;
@@ -1384,6 +1389,12 @@ public:
 
 		on_async_accepted(inputer);
 	}
+
+	void reply_late(Inputer3 & inputer)
+	{
+		on_async_accepted(inputer);
+		on_reply(inputer, SuccessReply());
+	}
 };
 
 
@@ -1507,6 +1518,169 @@ TEST_F(AsynchronousModelFixture, accept_input)
 }
 
 
+struct OutcomeRecorder
+{
+	void operator()(ap::mvc::InputOutcome<Implementation3> && outcome) { _outcomes.push_back(std::move(outcome)); }
+
+	std::vector<ap::mvc::InputOutcome<Implementation3>> _outcomes;
+};
+
+
+TEST_F(AsynchronousModelFixture, async_send)
+{
+	EXPECT_CALL(_inputers[1], accepted_cb())
+		.Times(0);
+	EXPECT_CALL(_inputers[1], rejected_cb())
+		.Times(0);
+	EXPECT_CALL(_inputers[1], mock_reply_cb(_))
+		.Times(0);
+	EXPECT_CALL(_model.view_bridge(), mock_get_int_listeners())
+		.Times(2)
+		.WillRepeatedly(ReturnRef(_int_listeners));
+
+	CreatedEvent<int> event(VALUES[3]);
+	CreatedEvent<int> other(VALUES[4]);
+
+	for ( unsigned i = 0; i < NB_VIEWS; ++i )
+	{
+		EXPECT_CALL(_views[i], handle_event(event))
+			.Times(1);
+		EXPECT_CALL(_views[i], handle_event(other))
+			.Times(1);
+	}
+
+	OutcomeRecorder recorder;
+
+	ap::mvc::InputFuture<Implementation3> accepted = _inputers[1].async_send(CreateCommand(eValueType::INTEGER, VALUES[3]));
+	EXPECT_FALSE(accepted.ready());
+
+	accepted.then(recorder);
+	EXPECT_FALSE(accepted.valid());
+	EXPECT_FALSE(accepted.ready());
+	EXPECT_TRUE(recorder._outcomes.empty());
+
+	_model.do_input(_inputers[1], CreateCommand(eValueType::INTEGER, VALUES[3]));
+
+	ASSERT_EQ(recorder._outcomes.size(), 1u);
+	EXPECT_EQ(ap::mvc::eInputStatus::ACCEPTED, recorder._outcomes[0].status);
+	ASSERT_TRUE(recorder._outcomes[0].reply.has_value());
+	EXPECT_EQ(SuccessReply(), *recorder._outcomes[0].reply);
+
+	ap::mvc::InputFuture<Implementation3> threaded = _inputers[1].async_send(CreateCommand(eValueType::INTEGER, VALUES[4]));
+	std::thread model([this]() { _model.do_input(_inputers[1], CreateCommand(eValueType::INTEGER, VALUES[4])); });
+	threaded.then(recorder);
+	model.join();
+
+	ASSERT_EQ(recorder._outcomes.size(), 2u);
+	EXPECT_EQ(ap::mvc::eInputStatus::ACCEPTED, recorder._outcomes[1].status);
+	EXPECT_TRUE(recorder._outcomes[1].reply.has_value());
+
+	_model.accept_input( false );
+	ap::mvc::InputFuture<Implementation3> rejected = _inputers[1].async_send(CreateCommand(eValueType::INTEGER, VALUES[5]));
+	_model.do_input(_inputers[1], CreateCommand(eValueType::INTEGER, VALUES[5]));
+
+	EXPECT_TRUE(rejected.ready());
+	rejected.then(recorder);
+
+	ASSERT_EQ(recorder._outcomes.size(), 3u);
+	EXPECT_EQ(ap::mvc::eInputStatus::REJECTED, recorder._outcomes[2].status);
+	EXPECT_FALSE(recorder._outcomes[2].reply.has_value());
+}
+
+
+TEST_F(AsynchronousModelFixture, async_send_pending)
+{
+	_model.accept_input( false );
+	ap::mvc::InputFuture<Implementation3> pending = _inputers[1].async_send(CreateCommand(eValueType::INTEGER, VALUES[3]));
+
+	EXPECT_THROW(_inputers[1].async_send(CreateCommand(eValueType::INTEGER, VALUES[4])), ap::mvc::EInputPending);
+	EXPECT_THROW(_inputers[1].send_input(CreateCommand(eValueType::INTEGER, VALUES[4])), ap::mvc::EInputPending);
+
+	OutcomeRecorder recorder;
+	pending.then(recorder);
+	_model.do_input(_inputers[1], CreateCommand(eValueType::INTEGER, VALUES[3]));
+
+	ASSERT_EQ(recorder._outcomes.size(), 1u);
+	EXPECT_EQ(ap::mvc::eInputStatus::REJECTED, recorder._outcomes[0].status);
+
+	ap::mvc::InputFuture<Implementation3> late = _inputers[1].async_send(CreateCommand(eValueType::INTEGER, VALUES[4]));
+	late.then(recorder);
+	EXPECT_THROW(_model.reply_late(_inputers[1]), ap::mvc::ELateReply);
+
+	ASSERT_EQ(recorder._outcomes.size(), 2u);
+	EXPECT_EQ(ap::mvc::eInputStatus::ACCEPTED, recorder._outcomes[1].status);
+	EXPECT_FALSE(recorder._outcomes[1].reply.has_value());
+}
+
+
+TEST_F(AsynchronousModelFixture, async_send_dropped)
+{
+	_inputers[1].async_send(CreateCommand(eValueType::INTEGER, VALUES[3]));
+
+	_model.accept_input( false );
+	EXPECT_CALL(_inputers[1], rejected_cb())
+		.Times(1);
+
+	_model.do_input(_inputers[1], CreateCommand(eValueType::INTEGER, VALUES[3]));
+
+	EXPECT_CALL(_inputers[0], rejected_cb())
+		.Times(0);
+
+	_inputers[0].disconnect();
+	ap::mvc::InputFuture<Implementation3> disconnected = _inputers[0].async_send(CreateCommand(eValueType::INTEGER, VALUES[3]));
+	EXPECT_TRUE(disconnected.ready());
+
+	OutcomeRecorder recorder;
+	disconnected.then(recorder);
+
+	ASSERT_EQ(recorder._outcomes.size(), 1u);
+	EXPECT_EQ(ap::mvc::eInputStatus::REJECTED, recorder._outcomes[0].status);
+}
+
+
+#if defined(APOPHENIC_TEST_COROUTINES) && ! defined(__cpp_impl_coroutine)
+#error "The C++20 tests need coroutines to await InputFuture"
+#endif
+
+#if defined(__cpp_impl_coroutine)
+struct DetachedTask
+{
+	struct promise_type
+	{
+		DetachedTask get_return_object() { return DetachedTask(); }
+		std::suspend_never initial_suspend() noexcept { return std::suspend_never(); }
+		std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+
+DetachedTask await_input(Inputer3 & inputer, const char * key, std::vector<ap::mvc::eInputStatus> & statuses)
+{
+	const ap::mvc::InputOutcome<Implementation3> outcome = co_await inputer.async_send(CreateCommand(eValueType::INTEGER, key));
+	statuses.push_back(outcome.status);
+}
+
+
+TEST_F(AsynchronousModelFixture, async_send_awaited)
+{
+	std::vector<ap::mvc::eInputStatus> statuses;
+
+	_model.accept_input( false );
+	await_input(_inputers[1], VALUES[3], statuses);
+	EXPECT_TRUE(statuses.empty());
+
+	_model.do_input(_inputers[1], CreateCommand(eValueType::INTEGER, VALUES[3]));
+	EXPECT_EQ(statuses, std::vector<ap::mvc::eInputStatus>({ap::mvc::eInputStatus::REJECTED}));
+
+	_inputers[0].disconnect();
+	await_input(_inputers[0], VALUES[3], statuses);
+	EXPECT_EQ(statuses, std::vector<ap::mvc::eInputStatus>({ap::mvc::eInputStatus::REJECTED, ap::mvc::eInputStatus::REJECTED}));
+}
+#endif
+
+
 #if 0
 TEST_F(AsynchronousModelFixture, test_all_commands)
 {
@@ -1531,6 +1705,1288 @@ TEST_F(AsynchronousModelFixture, test_all_commands)
 }
 #endif
 
+
+TEST(mvc, route_polymorphic_events)
+{
+	ViewBridge vc;
+	ViewString vs;
+	ViewAll va;
+
+	Implementation2::type_data<std::string>::init_data string_init_data;
+	Implementation2::type_data<integer>::init_data int_init_data;
+
+	EXPECT_CALL(vc, is_connection_allowed(_, kCONNECTION_CONTEXT))
+		.Times(2)
+		.WillRepeatedly(Return(true));
+	EXPECT_CALL(vc, enact_connection(_, kCONNECTION_CONTEXT))
+		.Times(2);
+	EXPECT_CALL(vc, mock_get_init_data(Matcher<const ViewBridge::StringListener &>(_)))
+		.Times(2)
+		.WillRepeatedly(ReturnRef(string_init_data));
+	EXPECT_CALL(vc, mock_get_init_data(Matcher<const ViewBridge::IntListener &>(Ref(va))))
+		.WillOnce(ReturnRef(int_init_data));
+	EXPECT_CALL(vs, mock_initialize(_));
+	EXPECT_CALL(va, mock_string_initialize(_));
+	EXPECT_CALL(va, mock_int_initialize(_));
+	EXPECT_CALL(vc, on_registered_cb(An< ViewBridge::StringListener & >()))
+		.Times(2);
+	EXPECT_CALL(vc, on_registered_cb(An< ViewBridge::IntListener & >()));
+
+	vs.connect(vc, kCONNECTION_CONTEXT);
+	va.connect(vc, kCONNECTION_CONTEXT);
+
+	std::list<ViewBridge::StringListener*> string_listeners;
+	std::list<ViewBridge::IntListener*> int_listeners;
+
+	string_listeners.push_back(&vs);
+	string_listeners.push_back(&va);
+	int_listeners.push_back(&va);
+
+	OnlyStringEvent event1("hello!");
+	PolymorphicEvent event2(2, "hello?");
+	OnlyStringEvent event3("how low?");
+	std::vector<IBaseEvent *> event_list;
+	event_list.push_back(&event1);
+	event_list.push_back(&event2);
+	event_list.push_back(&event3);
+
+	EXPECT_CALL(vc, mock_get_string_listeners())
+		.Times(4)
+		.WillRepeatedly(ReturnRef(string_listeners));
+	EXPECT_CALL(vc, mock_get_int_listeners())
+		.Times(2)
+		.WillRepeatedly(ReturnRef(int_listeners));
+	EXPECT_CALL(vs, handle_event(std::string("hello!")));
+	EXPECT_CALL(va, handle_event(std::string("hello!")));
+	EXPECT_CALL(vs, handle_event(std::string("hello?")))
+		.Times(2);
+	EXPECT_CALL(va, handle_event(std::string("hello?")))
+		.Times(2);
+	EXPECT_CALL(vs, handle_event(std::string("how low?")));
+	EXPECT_CALL(va, handle_event(std::string("how low?")));
+	EXPECT_CALL(va, handle_event(Matcher<const integer &>(_)))
+		.Times(2);
+
+	vc.route_events(event_list.begin(), event_list.end());
+	vc.route_generic_event(event2);
+
+	EXPECT_CALL(vc, is_connected(_))
+		.Times(2)
+		.WillRepeatedly(Return(true));
+	EXPECT_CALL(vc, enact_disconnection(_))
+		.Times(2);
+}
+
+
+class View4;
+class ViewBridge4;
+
+
+struct Implementation4
+{
+	typedef View4 view;
+	typedef ViewBridge4 view_bridge;
+	typedef ViewBridge4 event_emiter;
+	typedef unsigned int connection_context;
+
+	template<typename T>
+	struct type_data
+	{
+		typedef int init_data;
+	};
+};
+
+
+class View4 : public ap::mvc::View<Implementation4>
+{
+public:
+	virtual ~View4() {}
+};
+
+
+template<typename... TEvents>
+class DynamicView4
+	: public View4
+	, public ap::mvc::Listener<Implementation4, TEvents...>
+{};
+
+
+template<typename TBase>
+class Counting4 : public TBase
+{
+public:
+	Counting4() : _integers(0), _strings(0) {}
+
+	void initialize(int &&) override {}
+	void handle_event(const integer & event) { _integers += event._value; }
+	void handle_event(const std::string &) { ++_strings; }
+	void handle_event(const double &) {}
+
+	int _integers;
+	int _strings;
+};
+
+
+template<typename... TEvents>
+using CountingView4 = Counting4<DynamicView4<TEvents...>>;
+
+template<typename... TEvents>
+using StaticView4 = Counting4<ap::mvc::ListeningView<Implementation4, TEvents...>>;
+
+
+class DirectView4 : public Counting4<ap::mvc::StaticListeningView<DirectView4, Implementation4, integer, std::string>>
+{
+	typedef Counting4<ap::mvc::StaticListeningView<DirectView4, Implementation4, integer, std::string>> TCounting;
+
+public:
+	DirectView4() : _leave(nullptr) {}
+
+	using TCounting::handle_event;
+
+	void handle_event(const integer & event)
+	{
+		TCounting::handle_event(event);
+		if ( nullptr != _leave ) _leave->disconnect();
+	}
+
+	DirectView4 * _leave;
+};
+
+
+class BatchView4 : public Counting4<ap::mvc::ListeningView<Implementation4, integer, std::string>>
+{
+public:
+	BatchView4() : _batches(0) {}
+
+	void handle_events(const integer * const * events, std::size_t count) override
+	{
+		++_batches;
+		for (std::size_t i = 0; i < count; ++i) _integers += events[i]->_value;
+	}
+
+	int _batches;
+};
+
+
+class ViewBridge4
+	: public ap::mvc::ViewBridge<Implementation4>
+	, public ap::mvc::Emiter<Implementation4, integer, std::string>
+	, public ap::mvc::StaticListeners<Implementation4, DirectView4>
+{
+	friend class ap::mvc::Hub<ViewBridge4>;
+	typedef ap::mvc::Spoke<View4> Spoke;
+
+public:
+	ViewBridge4() : _rejected(-1) {}
+
+	template<typename TEvent>
+	bool filter(const TEvent &, ap::mvc::Listener<Implementation4,TEvent> *) const { return true; }
+
+	bool filter(const integer & event, ap::mvc::Listener<Implementation4,integer> *) const { return _rejected != event._value; }
+
+	int _rejected;
+
+protected:
+	void on_registered_cb(ap::mvc::Listener<Implementation4, integer> &) override {}
+	void on_registered_cb(ap::mvc::Listener<Implementation4, std::string> &) override {}
+	int get_init_data(const ap::mvc::Listener<Implementation4, integer> &) override { return 0; }
+	int get_init_data(const ap::mvc::Listener<Implementation4, std::string> &) override { return 0; }
+
+	bool is_connection_allowed(const Spoke & view, Implementation4::connection_context) { return false == is_connected(view); }
+	void enact_connection(Spoke & view, Implementation4::connection_context) { _views.push_back(&view); }
+	bool is_connected(const Spoke & view) { return _views.end() != std::find(_views.begin(), _views.end(), &view); }
+	void enact_disconnection(Spoke & view) { _views.erase(std::find(_views.begin(), _views.end(), &view)); }
+
+private:
+	std::vector<const Spoke *> _views;
+};
+
+
+TEST(mvc, listener_registry)
+{
+	typedef CountingView4<integer> IntView;
+	typedef ap::mvc::ListenerRegistry<Implementation4, integer> Registry;
+
+	IntView a, b, c;
+	Registry registry;
+
+	const ap::mvc::ListenerHandle ha = registry.add(a);
+	const ap::mvc::ListenerHandle hb = registry.add(b);
+	const ap::mvc::ListenerHandle hc = registry.add(c);
+
+	EXPECT_EQ(registry.size(), 3u);
+	EXPECT_TRUE(registry.remove(ha));
+	EXPECT_FALSE(registry.remove(ha));
+	EXPECT_FALSE(registry.contains(ha));
+	EXPECT_TRUE(registry.contains(hb));
+	EXPECT_TRUE(registry.contains(hc));
+	EXPECT_EQ(registry[0], &c);
+	EXPECT_EQ(registry[1], &b);
+
+	const ap::mvc::ListenerHandle hd = registry.add(a);
+	EXPECT_EQ(hd.slot, ha.slot);
+	EXPECT_FALSE(registry.contains(ha));
+	EXPECT_TRUE(registry.contains(hd));
+
+	{
+		IntView d;
+		registry.add(d);
+		EXPECT_EQ(registry.size(), 4u);
+	}
+
+	EXPECT_EQ(registry.size(), 3u);
+	EXPECT_TRUE(registry.remove(c));
+	EXPECT_TRUE(registry.contains(hb));
+	EXPECT_TRUE(registry.contains(hd));
+
+	int sum = 0;
+	for (ap::mvc::Listener<Implementation4, integer> * listener : registry)
+	{
+		sum += (listener == &a) + 2 * (listener == &b);
+	}
+	EXPECT_EQ(sum, 3);
+}
+
+
+TEST(mvc, registered_listeners)
+{
+	ViewBridge4 vc;
+	CountingView4<integer> vi;
+	CountingView4<std::string> vs;
+	CountingView4<integer, std::string> va;
+
+	vi.connect(vc, kCONNECTION_CONTEXT);
+	vs.connect(vc, kCONNECTION_CONTEXT);
+	va.connect(vc, kCONNECTION_CONTEXT);
+
+	EXPECT_EQ(vc.registered_listeners<integer>().size(), 2u);
+	EXPECT_EQ(vc.registered_listeners<std::string>().size(), 2u);
+
+	vc.propagate_generic_event(integer{3});
+	vc.propagate_generic_event(std::string("hello!"));
+
+	EXPECT_EQ(vi._integers, 3);
+	EXPECT_EQ(va._integers, 3);
+	EXPECT_EQ(vs._strings, 1);
+	EXPECT_EQ(va._strings, 1);
+
+	vi.disconnect();
+
+	EXPECT_EQ(vc.registered_listeners<integer>().size(), 1u);
+	EXPECT_EQ(vc.registered_listeners<std::string>().size(), 2u);
+
+	vc.propagate_generic_event(integer{4});
+
+	EXPECT_EQ(vi._integers, 3);
+	EXPECT_EQ(va._integers, 7);
+
+	{
+		CountingView4<integer> vt;
+		vt.connect(vc, kCONNECTION_CONTEXT);
+		EXPECT_EQ(vc.registered_listeners<integer>().size(), 2u);
+	}
+
+	EXPECT_EQ(vc.registered_listeners<integer>().size(), 1u);
+
+	vc.propagate_generic_event(integer{5});
+
+	EXPECT_EQ(va._integers, 12);
+}
+
+
+class LeavingView4 : public CountingView4<integer>
+{
+public:
+	LeavingView4() : _leave(nullptr) {}
+
+	void handle_event(const integer & event) override
+	{
+		CountingView4<integer>::handle_event(event);
+		if ( nullptr != _leave ) _leave->disconnect();
+	}
+
+	View4 * _leave;
+};
+
+
+TEST(mvc, registered_listeners_disconnect_from_handler)
+{
+	ViewBridge4 vc;
+	LeavingView4 first, second, third, last;
+
+	first.connect(vc, kCONNECTION_CONTEXT);
+	second.connect(vc, kCONNECTION_CONTEXT);
+	third.connect(vc, kCONNECTION_CONTEXT);
+	last.connect(vc, kCONNECTION_CONTEXT);
+
+	first._leave = &first;
+	second._leave = &third;
+
+	vc.propagate_generic_event(integer{1});
+
+	EXPECT_EQ(first._integers, 1);
+	EXPECT_EQ(second._integers, 1);
+	EXPECT_EQ(third._integers, 0);
+	EXPECT_EQ(last._integers, 1);
+
+	second._leave = nullptr;
+	last._leave = &second;
+	const integer two{2};
+	const integer * const batch[] = {&two};
+	vc.ap::mvc::Emiter<Implementation4, integer>::propagate_batch(batch, 1);
+
+	EXPECT_EQ(first._integers, 1);
+	EXPECT_EQ(second._integers, 1);
+	EXPECT_EQ(third._integers, 0);
+	EXPECT_EQ(last._integers, 3);
+	EXPECT_EQ(vc.registered_listeners<integer>().size(), 1u);
+}
+
+TEST(mvc, static_listener_registration)
+{
+	static_assert(std::is_same<StaticView4<integer, std::string>::listened_events, ap::mvc::EventList<integer, std::string>>::value, "");
+
+	ViewBridge4 vc;
+	StaticView4<integer> vi;
+	StaticView4<integer, std::string> va;
+	StaticView4<double> vd;
+
+	vi.connect(vc, kCONNECTION_CONTEXT);
+	va.connect(vc, kCONNECTION_CONTEXT);
+	vd.connect(vc, kCONNECTION_CONTEXT);
+
+	EXPECT_EQ(vi.bridge(), &vc);
+	EXPECT_EQ(va.bridge(), &vc);
+	EXPECT_EQ(vc.registered_listeners<integer>().size(), 2u);
+	EXPECT_EQ(vc.registered_listeners<std::string>().size(), 1u);
+
+	vc.propagate_generic_event(integer{3});
+	vc.propagate_generic_event(std::string("hello!"));
+
+	EXPECT_EQ(vi._integers, 3);
+	EXPECT_EQ(va._integers, 3);
+	EXPECT_EQ(va._strings, 1);
+
+	va.disconnect();
+
+	EXPECT_EQ(vc.registered_listeners<integer>().size(), 1u);
+	EXPECT_EQ(vc.registered_listeners<std::string>().size(), 0u);
+
+	vc.propagate_generic_event(integer{4});
+
+	EXPECT_EQ(vi._integers, 7);
+	EXPECT_EQ(va._integers, 3);
+}
+
+
+TEST(mvc, static_listener_dispatch)
+{
+	ViewBridge4 vc;
+	StaticView4<integer> vi;
+	DirectView4 da, db;
+
+	vi.connect(vc, kCONNECTION_CONTEXT);
+	da.connect(vc, kCONNECTION_CONTEXT);
+	db.connect(vc, kCONNECTION_CONTEXT);
+
+	EXPECT_EQ(vc.registered_listeners<integer>().size(), 1u);
+	EXPECT_EQ(vc.registered_listeners<std::string>().size(), 0u);
+	EXPECT_EQ(vc.typed_listeners<DirectView4>().size(), 2u);
+
+	vc.propagate_generic_event(integer{3});
+	vc.propagate_generic_event(std::string("hello!"));
+
+	EXPECT_EQ(vi._integers, 3);
+	EXPECT_EQ(da._integers, 3);
+	EXPECT_EQ(db._integers, 3);
+	EXPECT_EQ(da._strings, 1);
+	EXPECT_EQ(db._strings, 1);
+
+	da.disconnect();
+
+	ASSERT_EQ(vc.typed_listeners<DirectView4>().size(), 1u);
+	EXPECT_EQ(vc.typed_listeners<DirectView4>()[0], &db);
+
+	{
+		DirectView4 dt;
+		dt.connect(vc, kCONNECTION_CONTEXT);
+		EXPECT_EQ(vc.typed_listeners<DirectView4>().size(), 2u);
+	}
+
+	EXPECT_EQ(vc.typed_listeners<DirectView4>().size(), 1u);
+
+	vc.propagate_generic_event(integer{4});
+
+	EXPECT_EQ(vi._integers, 7);
+	EXPECT_EQ(da._integers, 3);
+	EXPECT_EQ(db._integers, 7);
+}
+
+
+TEST(mvc, static_listeners_disconnect_from_handler)
+{
+	ViewBridge4 vc;
+	DirectView4 first, second, third, last;
+
+	first.connect(vc, kCONNECTION_CONTEXT);
+	second.connect(vc, kCONNECTION_CONTEXT);
+	third.connect(vc, kCONNECTION_CONTEXT);
+	last.connect(vc, kCONNECTION_CONTEXT);
+
+	first._leave = &first;
+	second._leave = &third;
+
+	vc.propagate_generic_event(integer{1});
+
+	EXPECT_EQ(first._integers, 1);
+	EXPECT_EQ(second._integers, 1);
+	EXPECT_EQ(third._integers, 0);
+	EXPECT_EQ(last._integers, 1);
+
+	second._leave = nullptr;
+	last._leave = &second;
+	const integer two{2};
+	const integer * const batch[] = {&two};
+	vc.ap::mvc::Emiter<Implementation4, integer>::propagate_batch(batch, 1);
+
+	EXPECT_EQ(second._integers, 1);
+	EXPECT_EQ(last._integers, 3);
+	EXPECT_EQ(vc.typed_listeners<DirectView4>().size(), 1u);
+}
+
+
+TEST(mvc, propagate_batch)
+{
+	ViewBridge4 vc;
+	BatchView4 bv;
+	DirectView4 dv;
+	StaticView4<integer> vi;
+
+	bv.connect(vc, kCONNECTION_CONTEXT);
+	dv.connect(vc, kCONNECTION_CONTEXT);
+	vi.connect(vc, kCONNECTION_CONTEXT);
+
+	OnlyStringEvent event1("hello!");
+	PolymorphicEvent event2(2, "hello?");
+	PolymorphicEvent event3(5, "how low?");
+	PolymorphicEvent event4(7, "how high?");
+	std::vector<IBaseEvent *> event_list;
+	event_list.push_back(&event1);
+	event_list.push_back(&event2);
+	event_list.push_back(&event3);
+
+	vc.propagate_batch(event_list.begin(), event_list.end());
+
+	EXPECT_EQ(bv._batches, 1);
+	EXPECT_EQ(bv._integers, 7);
+	EXPECT_EQ(bv._strings, 3);
+	EXPECT_EQ(dv._integers, 7);
+	EXPECT_EQ(dv._strings, 3);
+	EXPECT_EQ(vi._integers, 7);
+
+	event_list.push_back(&event4);
+	vc._rejected = 5;
+	vc.propagate_batch(event_list.begin(), event_list.end());
+
+	EXPECT_EQ(bv._batches, 3);
+	EXPECT_EQ(bv._integers, 16);
+	EXPECT_EQ(bv._strings, 7);
+	EXPECT_EQ(dv._integers, 16);
+	EXPECT_EQ(vi._integers, 16);
+
+	const integer values[] = { {1}, {5}, {10} };
+	const integer * const batch[] = { values, values + 1, values + 2 };
+	vc.ap::mvc::Emiter<Implementation4, integer>::propagate_batch(batch, 3);
+
+	EXPECT_EQ(bv._batches, 5);
+	EXPECT_EQ(bv._integers, 27);
+	EXPECT_EQ(vi._integers, 27);
+}
+
+
+class View5;
+class ViewBridge5;
+
+
+struct Implementation5
+{
+	typedef View5 view;
+	typedef ViewBridge5 view_bridge;
+	typedef ViewBridge5 event_emiter;
+	typedef unsigned int connection_context;
+
+	template<typename T>
+	struct type_data
+	{
+		typedef int init_data;
+	};
+};
+
+
+class View5 : public ap::mvc::View<Implementation5>
+{
+public:
+	virtual ~View5() {}
+};
+
+
+class AsyncView5 : public ap::mvc::ListeningView<Implementation5, integer, std::string>
+{
+public:
+	AsyncView5() : _delay(0), _strings(0), _concurrent(false), _hold(false), _entered(0), _busy(false) {}
+	virtual ~AsyncView5() { disconnect(); }
+
+	void initialize(int &&) override {}
+
+	void handle_event(const integer & event) override
+	{
+		enter();
+		++_entered;
+		while ( _hold ) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		_values.push_back(event._value);
+		_payloads.push_back(&event);
+		if ( 0 != _delay ) std::this_thread::sleep_for(std::chrono::microseconds(_delay));
+		leave();
+	}
+
+	void handle_event(const std::string &) override
+	{
+		enter();
+		++_strings;
+		leave();
+	}
+
+	unsigned _delay;
+	std::vector<int> _values;
+	std::vector<const integer *> _payloads;
+	int _strings;
+	bool _concurrent;
+	std::atomic<bool> _hold;
+	std::atomic<int> _entered;
+
+private:
+	void enter() { if ( _busy.exchange(true) ) _concurrent = true; }
+	void leave() { _busy = false; }
+
+	std::atomic<bool> _busy;
+};
+
+
+class ViewBridge5
+	: public ap::mvc::ViewBridge<Implementation5>
+	, public ap::mvc::Emiter<Implementation5, integer, std::string>
+	, public ap::mvc::EventBus
+{
+	friend class ap::mvc::Hub<ViewBridge5>;
+	typedef ap::mvc::Spoke<View5> Spoke;
+
+public:
+	ViewBridge5(std::size_t capacity = kUNBOUNDED, ap::mvc::eOverflow overflow = ap::mvc::eOverflow::BLOCK)
+		: ap::mvc::EventBus(3, capacity, overflow) {}
+
+	template<typename TEvent>
+	bool filter(const TEvent &, ap::mvc::Listener<Implementation5,TEvent> *) const { return true; }
+
+protected:
+	void on_registered_cb(ap::mvc::Listener<Implementation5, integer> &) override {}
+	void on_registered_cb(ap::mvc::Listener<Implementation5, std::string> &) override {}
+	int get_init_data(const ap::mvc::Listener<Implementation5, integer> &) override { return 0; }
+	int get_init_data(const ap::mvc::Listener<Implementation5, std::string> &) override { return 0; }
+
+	bool is_connection_allowed(const Spoke & view, Implementation5::connection_context) { return false == is_connected(view); }
+	void enact_connection(Spoke & view, Implementation5::connection_context) { _views.push_back(&view); }
+	bool is_connected(const Spoke & view) { return _views.end() != std::find(_views.begin(), _views.end(), &view); }
+	void enact_disconnection(Spoke & view) { _views.erase(std::find(_views.begin(), _views.end(), &view)); }
+
+private:
+	std::vector<const Spoke *> _views;
+};
+
+
+TEST(mvc, async_event_bus)
+{
+	constexpr int NB_EVENTS = 1000;
+
+	ViewBridge5 vc;
+	AsyncView5 views[4];
+
+	for (AsyncView5 & view : views) view.connect(vc, kCONNECTION_CONTEXT);
+
+	for (int i = 0; i < NB_EVENTS; ++i)
+	{
+		vc.propagate_generic_event(integer{i});
+		if ( 0 == i % 10 ) vc.propagate_generic_event(std::string("tick"));
+	}
+
+	vc.wait_idle();
+
+	for (AsyncView5 & view : views)
+	{
+		ASSERT_EQ(view._values.size(), static_cast<std::size_t>(NB_EVENTS));
+		for (int i = 0; i < NB_EVENTS; ++i) EXPECT_EQ(view._values[i], i);
+		EXPECT_EQ(view._strings, NB_EVENTS / 10);
+		EXPECT_FALSE(view._concurrent);
+		EXPECT_EQ(view._payloads, views[0]._payloads);
+	}
+}
+
+
+TEST(mvc, async_disconnect)
+{
+	ViewBridge5 vc;
+	AsyncView5 slow, fast;
+
+	slow._delay = 200;
+	slow.connect(vc, kCONNECTION_CONTEXT);
+	fast.connect(vc, kCONNECTION_CONTEXT);
+
+	for (int i = 0; i < 100; ++i) vc.propagate_generic_event(integer{i});
+
+	slow.disconnect();
+	const std::size_t delivered = slow._values.size();
+
+	EXPECT_EQ(vc.registered_listeners<integer>().size(), 1u);
+
+	for (int i = 100; i < 200; ++i) vc.propagate_generic_event(integer{i});
+
+	vc.wait_idle();
+
+	EXPECT_EQ(slow._values.size(), delivered);
+	EXPECT_EQ(fast._values.size(), 200u);
+
+	{
+		AsyncView5 scoped;
+		scoped._delay = 200;
+		scoped.connect(vc, kCONNECTION_CONTEXT);
+		for (int i = 0; i < 20; ++i) vc.propagate_generic_event(integer{i});
+	}
+
+	vc.wait_idle();
+}
+
+// Holds the first event in the handlers of the views, then posts the others behind it.
+static void overflow_mailboxes(ViewBridge5 & vc, std::vector<AsyncView5 *> views, int count)
+{
+	for (AsyncView5 * view : views) view->_hold = true;
+	vc.propagate_generic_event(integer{0});
+	for (AsyncView5 * view : views) while ( 0 == view->_entered ) std::this_thread::yield();
+
+	for (int i = 1; i < count; ++i) vc.propagate_generic_event(integer{i});
+}
+
+
+TEST(mvc, bounded_mailboxes)
+{
+	ViewBridge5 vc(4, ap::mvc::eOverflow::DROP_OLDEST);
+	AsyncView5 oldest, newest;
+
+	oldest.connect(vc, kCONNECTION_CONTEXT);
+	newest.connect(vc, kCONNECTION_CONTEXT);
+	vc.bound(&newest, 4, ap::mvc::eOverflow::DROP_NEWEST);
+
+	overflow_mailboxes(vc, {&oldest, &newest}, 11);
+
+	const ap::mvc::QueueStats stats = vc.stats(&oldest);
+	EXPECT_EQ(stats.depth, 4u);
+	EXPECT_EQ(stats.high_water, 4u);
+	EXPECT_EQ(stats.dropped, 6u);
+	EXPECT_EQ(vc.stats(&newest).dropped, 6u);
+
+	oldest._hold = newest._hold = false;
+	vc.wait_idle();
+
+	EXPECT_EQ(oldest._values, std::vector<int>({0, 7, 8, 9, 10}));
+	EXPECT_EQ(newest._values, std::vector<int>({0, 1, 2, 3, 4}));
+	EXPECT_EQ(vc.stats(&oldest).depth, 0u);
+}
+
+
+TEST(mvc, bounded_mailbox_block)
+{
+	ViewBridge5 vc(2);
+	AsyncView5 view;
+
+	view.connect(vc, kCONNECTION_CONTEXT);
+	overflow_mailboxes(vc, {&view}, 3);
+
+	std::atomic<bool> posted(false);
+	std::thread producer([&vc, &posted]()
+	{
+		vc.propagate_generic_event(integer{3});
+		posted = true;
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	EXPECT_FALSE(posted);
+
+	view._hold = false;
+	producer.join();
+	vc.wait_idle();
+
+	EXPECT_EQ(view._values, std::vector<int>({0, 1, 2, 3}));
+	EXPECT_EQ(vc.stats(&view).high_water, 2u);
+	EXPECT_EQ(vc.stats(&view).dropped, 0u);
+}
+
+
+TEST(mvc, bounded_mailbox_disconnect)
+{
+	ViewBridge5 vc(2, ap::mvc::eOverflow::DISCONNECT);
+	AsyncView5 slow, fast;
+
+	slow.connect(vc, kCONNECTION_CONTEXT);
+	fast.connect(vc, kCONNECTION_CONTEXT);
+	vc.bound(&fast, ViewBridge5::kUNBOUNDED, ap::mvc::eOverflow::BLOCK);
+	overflow_mailboxes(vc, {&slow}, 3);
+
+	std::thread release([&slow]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		slow._hold = false;
+	});
+
+	vc.propagate_generic_event(integer{3});
+	release.join();
+
+	EXPECT_FALSE(slow.is_connected());
+	EXPECT_EQ(vc.registered_listeners<integer>().size(), 1u);
+
+	vc.propagate_generic_event(integer{4});
+	vc.wait_idle();
+
+	EXPECT_EQ(slow._values, std::vector<int>({0}));
+	EXPECT_EQ(fast._values, std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+
+
+class ViewBridge6;
+class View6;
+
+
+struct Implementation6
+{
+	typedef View6 view;
+	typedef ViewBridge6 view_bridge;
+	typedef ViewBridge6 event_emiter;
+	typedef unsigned int connection_context;
+
+	template<typename T>
+	struct type_data
+	{
+		typedef int init_data;
+	};
+};
+
+
+class View6 : public ap::mvc::View<Implementation6>
+{
+public:
+	virtual ~View6() {}
+};
+
+
+class SharedView6 : public ap::mvc::ListeningView<Implementation6, integer>
+{
+public:
+	SharedView6() : _received(0), _late(0), _disconnected(false), _other(nullptr) {}
+	// Leaves before its members are destroyed, as ConcurrentHub requires.
+	virtual ~SharedView6() { disconnect(); }
+
+	void initialize(int &&) override {}
+
+	void handle_event(const integer &) override
+	{
+		++_received;
+		if ( _disconnected ) ++_late;
+		if ( nullptr != _other ) _other->disconnect();
+	}
+
+	void leave()
+	{
+		disconnect();
+		_disconnected = true;
+	}
+
+	std::atomic<int> _received;
+	std::atomic<int> _late;
+	std::atomic<bool> _disconnected;
+	SharedView6 * _other;
+};
+
+
+class ViewBridge6
+	: public ap::mvc::ViewBridge<Implementation6>
+	, public ap::mvc::Emiter<Implementation6, integer>
+	, public ap::mvc::ConcurrentHub
+{
+	friend class ap::mvc::Hub<ViewBridge6>;
+	typedef ap::mvc::Spoke<View6> Spoke;
+
+public:
+	bool filter(const integer &, ap::mvc::Listener<Implementation6,integer> *) const { return true; }
+
+protected:
+	void on_registered_cb(ap::mvc::Listener<Implementation6, integer> &) override {}
+	int get_init_data(const ap::mvc::Listener<Implementation6, integer> &) override { return 0; }
+
+	bool is_connection_allowed(const Spoke & view, Implementation6::connection_context) { return false == is_connected(view); }
+	void enact_connection(Spoke & view, Implementation6::connection_context) { _views.push_back(&view); }
+	bool is_connected(const Spoke & view) { return _views.end() != std::find(_views.begin(), _views.end(), &view); }
+	void enact_disconnection(Spoke & view) { _views.erase(std::find(_views.begin(), _views.end(), &view)); }
+
+private:
+	std::vector<const Spoke *> _views;
+};
+
+
+TEST(mvc, concurrent_connections)
+{
+	ViewBridge6 vc;
+	SharedView6 steady;
+	std::atomic<bool> stop(false);
+	int propagated = 0;
+
+	steady.connect(vc, kCONNECTION_CONTEXT);
+
+	std::thread model([&vc, &stop, &propagated]()
+	{
+		while ( false == stop ) vc.propagate_event(integer{propagated++});
+	});
+
+	std::vector<std::thread> controllers;
+	std::atomic<int> late(0);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		controllers.emplace_back([&vc, &late]()
+		{
+			for (int j = 0; j < 200; ++j)
+			{
+				SharedView6 * const view = new SharedView6();
+				view->connect(vc, kCONNECTION_CONTEXT);
+				std::this_thread::yield();
+				view->leave();
+				late += view->_late;
+				delete view;
+
+				SharedView6 scoped;
+				scoped.connect(vc, kCONNECTION_CONTEXT);
+			}
+		});
+	}
+
+	for (std::thread & controller : controllers) controller.join();
+	stop = true;
+	model.join();
+
+	EXPECT_EQ(late, 0);
+	EXPECT_EQ(steady._received, propagated);
+	EXPECT_EQ(vc.registered_listeners<integer>().size(), 1u);
+}
+
+
+TEST(mvc, concurrent_disconnect_from_handler)
+{
+	ViewBridge6 vc;
+	SharedView6 first, second;
+
+	first._other = &second;
+	first.connect(vc, kCONNECTION_CONTEXT);
+	second.connect(vc, kCONNECTION_CONTEXT);
+
+	vc.propagate_event(integer{1});
+
+	EXPECT_EQ(first._received, 1);
+	EXPECT_EQ(second._received, 0);
+	EXPECT_FALSE(second.is_connected());
+	EXPECT_EQ(vc.registered_listeners<integer>().size(), 1u);
+
+	second.connect(vc, kCONNECTION_CONTEXT);
+	first._other = nullptr;
+	vc.propagate_event(integer{2});
+
+	EXPECT_EQ(first._received, 2);
+	EXPECT_EQ(second._received, 1);
+}
+
+
+class ViewBridge7;
+class View7;
+
+
+struct quote
+{
+	std::string _symbol;
+	int _price;
+};
+
+
+struct Implementation7
+{
+	typedef View7 view;
+	typedef ViewBridge7 view_bridge;
+	typedef ViewBridge7 event_emiter;
+	typedef unsigned int connection_context;
+
+	template<typename T>
+	struct type_data
+	{
+		typedef int init_data;
+		typedef std::string subscription_key;
+	};
+};
+
+
+class View7 : public ap::mvc::View<Implementation7>
+{
+public:
+	virtual ~View7() {}
+};
+
+
+class QuoteView7 : public ap::mvc::ListeningView<Implementation7, quote>
+{
+public:
+	QuoteView7(std::vector<std::string> keys = {}, std::vector<std::string> prefixes = {})
+		: _keys(std::move(keys)), _prefixes(std::move(prefixes)), _calls(0), _leave(false), _relay(nullptr) {}
+
+	void initialize(int &&) override {}
+
+	void subscribe(ap::mvc::Subscriptions<Implementation7, quote> & subscriptions) const override
+	{
+		for (const std::string & key : _keys) subscriptions.key(key);
+		for (const std::string & prefix : _prefixes) subscriptions.prefix(prefix);
+	}
+
+	void handle_event(const quote & event) override;
+
+	void handle_events(const quote * const * events, std::size_t count) override
+	{
+		++_calls;
+		ap::mvc::Listener<Implementation7, quote>::handle_events(events, count);
+	}
+
+	std::vector<std::string> _keys;
+	std::vector<std::string> _prefixes;
+	std::vector<std::string> _symbols;
+	int _calls;
+	bool _leave;
+	ViewBridge7 * _relay;
+};
+
+
+class ViewBridge7
+	: public ap::mvc::ViewBridge<Implementation7>
+	, public ap::mvc::Emiter<Implementation7, quote>
+{
+	friend class ap::mvc::Hub<ViewBridge7>;
+	typedef ap::mvc::Spoke<View7> Spoke;
+
+public:
+	ViewBridge7() : _filtered(0) {}
+
+	const std::string & event_key(const quote & event) const { return event._symbol; }
+
+	bool filter(const quote & event, ap::mvc::Listener<Implementation7,quote> *) const
+	{
+		++_filtered;
+		return 0 <= event._price;
+	}
+
+	mutable int _filtered;
+
+protected:
+	void on_registered_cb(ap::mvc::Listener<Implementation7, quote> &) override {}
+	int get_init_data(const ap::mvc::Listener<Implementation7, quote> &) override { return 0; }
+
+	bool is_connection_allowed(const Spoke & view, Implementation7::connection_context) { return false == is_connected(view); }
+	void enact_connection(Spoke & view, Implementation7::connection_context) { _views.push_back(&view); }
+	bool is_connected(const Spoke & view) { return _views.end() != std::find(_views.begin(), _views.end(), &view); }
+	void enact_disconnection(Spoke & view) { _views.erase(std::find(_views.begin(), _views.end(), &view)); }
+
+private:
+	std::vector<const Spoke *> _views;
+};
+
+
+void QuoteView7::handle_event(const quote & event)
+{
+	_symbols.push_back(event._symbol);
+
+	if ( nullptr != _relay )
+	{
+		ViewBridge7 * const relay = _relay;
+		_relay = nullptr;
+		relay->propagate_event(quote{event._symbol + "+", event._price});
+	}
+
+	if ( _leave ) disconnect();
+}
+
+
+TEST(mvc, subscription_index)
+{
+	ViewBridge7 vc;
+	QuoteView7 apple({"AAPL"});
+	QuoteView7 ms({"MSFT"}, {"MS"});
+	QuoteView7 all;
+	std::vector<QuoteView7> idle(100, QuoteView7({"IDLE"}));
+
+	apple.connect(vc, kCONNECTION_CONTEXT);
+	ms.connect(vc, kCONNECTION_CONTEXT);
+	all.connect(vc, kCONNECTION_CONTEXT);
+	for (QuoteView7 & view : idle) view.connect(vc, kCONNECTION_CONTEXT);
+
+	vc.propagate_event(quote{"AAPL", 1});
+	vc.propagate_event(quote{"MSFT", 2});
+	vc.propagate_event(quote{"MSCI", 3});
+	vc.propagate_event(quote{"M", 4});
+	vc.propagate_event(quote{"MSFT", -1});
+
+	EXPECT_EQ(apple._symbols, std::vector<std::string>({"AAPL"}));
+	EXPECT_EQ(ms._symbols, std::vector<std::string>({"MSFT", "MSCI"}));
+	EXPECT_EQ(all._symbols, std::vector<std::string>({"AAPL", "MSFT", "MSCI", "M"}));
+	EXPECT_EQ(vc._filtered, 9);
+
+	ms.disconnect();
+	vc.propagate_event(quote{"MSFT", 5});
+
+	EXPECT_EQ(ms._symbols.size(), 2u);
+	EXPECT_EQ(all._symbols.size(), 5u);
+
+	const quote batch[] = { {"AAPL", 6}, {"MSFT", 7}, {"AAPL", -1}, {"AAPL", 8} };
+	const quote * const events[] = { &batch[0], &batch[1], &batch[2], &batch[3] };
+	apple._calls = all._calls = 0;
+	vc.propagate_batch(events, 4);
+
+	EXPECT_EQ(apple._symbols, std::vector<std::string>({"AAPL", "AAPL", "AAPL"}));
+	EXPECT_EQ(apple._calls, 1);
+	EXPECT_EQ(all._symbols.size(), 8u);
+	EXPECT_EQ(all._calls, 2);
+
+	for (const QuoteView7 & view : idle) EXPECT_TRUE(view._symbols.empty());
+}
+
+
+TEST(mvc, subscription_disconnect_from_handler)
+{
+	ViewBridge7 vc;
+	QuoteView7 leaving, first, last;
+	QuoteView7 apple({"AAPL"}), apple_plus({"AAPL+"});
+
+	leaving._leave = true;
+	first._relay = &vc;
+	leaving.connect(vc, kCONNECTION_CONTEXT);
+	first.connect(vc, kCONNECTION_CONTEXT);
+	last.connect(vc, kCONNECTION_CONTEXT);
+	apple.connect(vc, kCONNECTION_CONTEXT);
+	apple_plus.connect(vc, kCONNECTION_CONTEXT);
+
+	vc.propagate_event(quote{"AAPL", 1});
+
+	EXPECT_FALSE(leaving.is_connected());
+	EXPECT_EQ(leaving._symbols, std::vector<std::string>({"AAPL"}));
+	EXPECT_EQ(first._symbols, std::vector<std::string>({"AAPL", "AAPL+"}));
+	EXPECT_EQ(last._symbols, std::vector<std::string>({"AAPL+", "AAPL"}));
+	EXPECT_EQ(apple._symbols, std::vector<std::string>({"AAPL"}));
+	EXPECT_EQ(apple_plus._symbols, std::vector<std::string>({"AAPL+"}));
+}
+
+
+class ViewBridge8;
+class View8;
+
+
+struct Implementation8
+{
+	typedef View8 view;
+	typedef ViewBridge8 view_bridge;
+	typedef ViewBridge8 event_emiter;
+	typedef unsigned int connection_context;
+
+	template<typename T>
+	struct type_data
+	{
+		typedef int init_data;
+		typedef std::string conflation_key;
+	};
+};
+
+
+class View8 : public ap::mvc::View<Implementation8>
+{
+public:
+	virtual ~View8() {}
+};
+
+
+class CachingView8 : public ap::mvc::ListeningView<Implementation8, IIntEvent>
+{
+public:
+	CachingView8() : _calls(0), _leave(nullptr) {}
+
+	void initialize(int &&) override {}
+
+	void handle_event(const IIntEvent & event) override
+	{
+		switch ( event.action() )
+		{
+		case eAction::CREATION:
+			_changes.push_back("+" + event.key());
+			break;
+		case eAction::DESTRUCTION:
+			_changes.push_back("-" + event.key());
+			break;
+		case eAction::MODIFICATION:
+			_changes.push_back(event.key() + "=" + std::to_string(static_cast<const ModifiedEvent<int> &>(event).new_value()));
+			break;
+		}
+	}
+
+	void handle_events(const IIntEvent * const * events, std::size_t count) override
+	{
+		++_calls;
+		ap::mvc::Listener<Implementation8, IIntEvent>::handle_events(events, count);
+		if ( nullptr != _leave ) _leave->disconnect();
+	}
+
+	std::vector<std::string> _changes;
+	int _calls;
+	CachingView8 * _leave;
+};
+
+
+class ViewBridge8
+	: public ap::mvc::ViewBridge<Implementation8>
+	, public ap::mvc::Emiter<Implementation8, IIntEvent>
+{
+	friend class ap::mvc::Hub<ViewBridge8>;
+	typedef ap::mvc::Spoke<View8> Spoke;
+
+public:
+	const std::string & event_key(const IIntEvent & event) const { return event.key(); }
+
+	ap::mvc::eChange event_change(const IIntEvent & event) const
+	{
+		switch ( event.action() )
+		{
+		case eAction::CREATION:
+			return ap::mvc::eChange::CREATION;
+		case eAction::DESTRUCTION:
+			return ap::mvc::eChange::DESTRUCTION;
+		case eAction::MODIFICATION:
+			break;
+		}
+
+		return ap::mvc::eChange::MODIFICATION;
+	}
+
+	bool filter(const IIntEvent &, ap::mvc::Listener<Implementation8,IIntEvent> *) const { return true; }
+
+	void created(const std::string & key) { propagate_shared(std::make_shared<const CreatedEvent<int>>(key)); }
+	void modified(const std::string & key, int value) { propagate_shared(std::make_shared<const ModifiedEvent<int>>(key, value)); }
+	void destroyed(const std::string & key) { propagate_shared(std::make_shared<const DestroyedEvent<int>>(key)); }
+
+	std::size_t pending(const CachingView8 & view) const { return registered_listeners<IIntEvent>().queues().size(view); }
+
+protected:
+	void on_registered_cb(ap::mvc::Listener<Implementation8, IIntEvent> &) override {}
+	int get_init_data(const ap::mvc::Listener<Implementation8, IIntEvent> &) override { return 0; }
+
+	bool is_connection_allowed(const Spoke & view, Implementation8::connection_context) { return false == is_connected(view); }
+	void enact_connection(Spoke & view, Implementation8::connection_context) { _views.push_back(&view); }
+	bool is_connected(const Spoke & view) { return _views.end() != std::find(_views.begin(), _views.end(), &view); }
+	void enact_disconnection(Spoke & view) { _views.erase(std::find(_views.begin(), _views.end(), &view)); }
+
+private:
+	std::vector<const Spoke *> _views;
+};
+
+
+TEST(mvc, conflating_queues)
+{
+	ViewBridge8 vc;
+	CachingView8 slow, fast;
+
+	slow.connect(vc, kCONNECTION_CONTEXT);
+	fast.connect(vc, kCONNECTION_CONTEXT);
+
+	vc.created("a");
+	vc.modified("a", 1);
+	vc.modified("b", 1);
+	vc.deliver_pending(fast);
+
+	for (int i = 2; i < 1000; ++i) vc.modified("a", i);
+	vc.modified("b", 2);
+	vc.destroyed("c");
+	vc.created("d");
+	vc.modified("d", 1);
+	vc.destroyed("d");
+	vc.modified("e", 1);
+	vc.destroyed("e");
+	vc.destroyed("f");
+	vc.created("f");
+
+	EXPECT_TRUE(slow._changes.empty());
+	EXPECT_EQ(vc.pending(slow), 7u);
+	EXPECT_EQ(vc.pending(fast), 6u);
+
+	vc.deliver_pending(slow);
+
+	EXPECT_EQ(slow._changes, std::vector<std::string>({"+a", "a=999", "b=2", "-c", "-e", "-f", "+f"}));
+	EXPECT_EQ(slow._calls, 1);
+	EXPECT_EQ(vc.pending(slow), 0u);
+
+	vc.deliver_pending();
+
+	EXPECT_EQ(fast._changes, std::vector<std::string>({"+a", "a=1", "b=1", "a=999", "b=2", "-c", "-e", "-f", "+f"}));
+	EXPECT_EQ(fast._calls, 2);
+
+	vc.modified("a", 1000);
+	EXPECT_EQ(vc.pending(fast), 1u);
+
+	fast.disconnect();
+	EXPECT_EQ(vc.pending(fast), 0u);
+
+	vc.deliver_pending();
+	EXPECT_EQ(slow._changes.size(), 8u);
+	EXPECT_EQ(fast._changes.size(), 9u);
+}
+
+
+TEST(mvc, conflating_queues_disconnect_from_handler)
+{
+	ViewBridge8 vc;
+	CachingView8 first, second, third, last;
+
+	first.connect(vc, kCONNECTION_CONTEXT);
+	second.connect(vc, kCONNECTION_CONTEXT);
+	third.connect(vc, kCONNECTION_CONTEXT);
+	last.connect(vc, kCONNECTION_CONTEXT);
+
+	first._leave = &first;
+	second._leave = &third;
+
+	vc.modified("a", 1);
+	vc.deliver_pending();
+
+	EXPECT_EQ(first._calls, 1);
+	EXPECT_EQ(second._calls, 1);
+	EXPECT_EQ(third._calls, 0);
+	EXPECT_EQ(last._calls, 1);
+
+	second._leave = nullptr;
+	vc.modified("a", 2);
+	vc.deliver_pending();
+
+	EXPECT_EQ(first._calls, 1);
+	EXPECT_EQ(second._calls, 2);
+	EXPECT_EQ(third._calls, 0);
+	EXPECT_EQ(last._calls, 2);
+}
+
+
 int main(int argc, char **argv)
 {
 	::testing::InitGoogleTest(&argc, argv);